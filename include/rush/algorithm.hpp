@@ -9,6 +9,18 @@
 #define RUSH_ALGORITHM_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 namespace rush {
 
@@ -62,6 +74,1027 @@ constexpr const T &clamph(const T &v, const T &hi) {
   return (v > hi) ? hi : v;
 }
 
+/**
+ * @brief Clamps an arithmetic value within the inclusive range [lo, hi], returning it by value.
+ *
+ * Unlike clamp, the result does not refer to any of the arguments, so it is safe to use with temporaries,
+ * and it is computed with conditional moves or min/max instructions instead of branches.
+ *
+ * @tparam T The arithmetic type of the value and the bounds.
+ * @param v The value to clamp.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ * @return The clamped value.
+ */
+template <class T>
+[[nodiscard]] constexpr T clamp_value(const T v, const T lo, const T hi) {
+  static_assert(std::is_arithmetic_v<T>);
+  const T a = (v < lo) ? lo : v;
+  return (a > hi) ? hi : a;
+}
+
+/**
+ * @brief Clamps an arithmetic value to be not less than a specified lower bound, returning it by value.
+ *
+ * @tparam T The arithmetic type of the value and the lower bound.
+ * @param v The value to clamp.
+ * @param lo The lower bound.
+ * @return The clamped value.
+ * @see clamp_value(const T v, const T lo, const T hi)
+ */
+template <class T>
+[[nodiscard]] constexpr T clampl_value(const T v, const T lo) {
+  static_assert(std::is_arithmetic_v<T>);
+  return (v < lo) ? lo : v;
+}
+
+/**
+ * @brief Clamps an arithmetic value to be not greater than a specified upper bound, returning it by value.
+ *
+ * @tparam T The arithmetic type of the value and the upper bound.
+ * @param v The value to clamp.
+ * @param hi The upper bound.
+ * @return The clamped value.
+ * @see clamp_value(const T v, const T lo, const T hi)
+ */
+template <class T>
+[[nodiscard]] constexpr T clamph_value(const T v, const T hi) {
+  static_assert(std::is_arithmetic_v<T>);
+  return (v > hi) ? hi : v;
+}
+
+/**
+ * @brief Clamps an arithmetic variable within the inclusive range [lo, hi] in place.
+ *
+ * @tparam T The arithmetic type of the variable and the bounds.
+ * @param v The variable to clamp.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ * @see clamp_value(const T v, const T lo, const T hi)
+ */
+template <class T>
+constexpr void clamp_inplace(T &v, const T lo, const T hi) {
+  v = clamp_value(v, lo, hi);
+}
+
+/**
+ * @brief Clamps an arithmetic variable to be not less than a specified lower bound in place.
+ *
+ * @tparam T The arithmetic type of the variable and the lower bound.
+ * @param v The variable to clamp.
+ * @param lo The lower bound.
+ * @see clampl_value(const T v, const T lo)
+ */
+template <class T>
+constexpr void clampl_inplace(T &v, const T lo) {
+  v = clampl_value(v, lo);
+}
+
+/**
+ * @brief Clamps an arithmetic variable to be not greater than a specified upper bound in place.
+ *
+ * @tparam T The arithmetic type of the variable and the upper bound.
+ * @param v The variable to clamp.
+ * @param hi The upper bound.
+ * @see clamph_value(const T v, const T hi)
+ */
+template <class T>
+constexpr void clamph_inplace(T &v, const T hi) {
+  v = clamph_value(v, hi);
+}
+
+/*! \cond INTERNAL */
+namespace detail {
+
+template <typename T>
+struct type_identity {
+  using type = T;
+};
+
+template <typename T>
+using type_identity_t = typename type_identity<T>::type;
+
+#define DEFINE_SIMD_MACRO(type, vector, lanes, load_, store_, set1_, min_, max_) \
+  template <>                                                                  \
+  struct Simd<type> {                                                          \
+    using V = vector;                                                          \
+    static constexpr std::size_t width = lanes;                                \
+    static V load(const type *p) {                                             \
+      return load_;                                                            \
+    }                                                                          \
+    static void store(type *p, const V v) {                                    \
+      store_;                                                                  \
+    }                                                                          \
+    static V set1(const type x) {                                              \
+      return set1_;                                                            \
+    }                                                                          \
+    static V min(const V a, const V b) {                                       \
+      return min_;                                                             \
+    }                                                                          \
+    static V max(const V a, const V b) {                                       \
+      return max_;                                                             \
+    }                                                                          \
+  };
+
+template <typename T>
+struct Simd {
+  static constexpr std::size_t width = 1;
+};
+
+#if defined(__AVX__)
+DEFINE_SIMD_MACRO(float, __m256, 8, _mm256_loadu_ps(p), _mm256_storeu_ps(p, v), _mm256_set1_ps(x), _mm256_min_ps(a, b), _mm256_max_ps(a, b))
+DEFINE_SIMD_MACRO(double, __m256d, 4, _mm256_loadu_pd(p), _mm256_storeu_pd(p, v), _mm256_set1_pd(x), _mm256_min_pd(a, b), _mm256_max_pd(a, b))
+#elif defined(__SSE2__)
+DEFINE_SIMD_MACRO(float, __m128, 4, _mm_loadu_ps(p), _mm_storeu_ps(p, v), _mm_set1_ps(x), _mm_min_ps(a, b), _mm_max_ps(a, b))
+DEFINE_SIMD_MACRO(double, __m128d, 2, _mm_loadu_pd(p), _mm_storeu_pd(p, v), _mm_set1_pd(x), _mm_min_pd(a, b), _mm_max_pd(a, b))
+#endif
+
+#if defined(__AVX2__)
+#define DEFINE_SIMD_INTEGER_MACRO(type, suffix, lanes, set1_) \
+  DEFINE_SIMD_MACRO(type, __m256i, lanes, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v), set1_, _mm256_min_##suffix(a, b), _mm256_max_##suffix(a, b))
+DEFINE_SIMD_INTEGER_MACRO(std::int8_t, epi8, 32, _mm256_set1_epi8(x))
+DEFINE_SIMD_INTEGER_MACRO(std::uint8_t, epu8, 32, _mm256_set1_epi8(static_cast<char>(x)))
+DEFINE_SIMD_INTEGER_MACRO(std::int16_t, epi16, 16, _mm256_set1_epi16(x))
+DEFINE_SIMD_INTEGER_MACRO(std::uint16_t, epu16, 16, _mm256_set1_epi16(static_cast<short>(x)))
+DEFINE_SIMD_INTEGER_MACRO(std::int32_t, epi32, 8, _mm256_set1_epi32(x))
+DEFINE_SIMD_INTEGER_MACRO(std::uint32_t, epu32, 8, _mm256_set1_epi32(static_cast<int>(x)))
+#undef DEFINE_SIMD_INTEGER_MACRO
+#elif defined(__SSE4_1__)
+#define DEFINE_SIMD_INTEGER_MACRO(type, suffix, lanes, set1_) \
+  DEFINE_SIMD_MACRO(type, __m128i, lanes, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v), set1_, _mm_min_##suffix(a, b), _mm_max_##suffix(a, b))
+DEFINE_SIMD_INTEGER_MACRO(std::int8_t, epi8, 16, _mm_set1_epi8(x))
+DEFINE_SIMD_INTEGER_MACRO(std::uint8_t, epu8, 16, _mm_set1_epi8(static_cast<char>(x)))
+DEFINE_SIMD_INTEGER_MACRO(std::int16_t, epi16, 8, _mm_set1_epi16(x))
+DEFINE_SIMD_INTEGER_MACRO(std::uint16_t, epu16, 8, _mm_set1_epi16(static_cast<short>(x)))
+DEFINE_SIMD_INTEGER_MACRO(std::int32_t, epi32, 4, _mm_set1_epi32(x))
+DEFINE_SIMD_INTEGER_MACRO(std::uint32_t, epu32, 4, _mm_set1_epi32(static_cast<int>(x)))
+#undef DEFINE_SIMD_INTEGER_MACRO
+#endif
+
+#undef DEFINE_SIMD_MACRO
+
+template <bool Lo, bool Hi, typename T>
+void clamp_kernel(const T *in, T *out, const std::size_t n, const T lo, const T hi) {
+  std::size_t i = 0;
+  if constexpr(Simd<T>::width > 1) {
+    using S = Simd<T>;
+    const typename S::V vlo = S::set1(lo);
+    const typename S::V vhi = S::set1(hi);
+    for(; i + S::width <= n; i += S::width) {
+      typename S::V v = S::load(in + i);
+      if constexpr(Lo) {
+        v = S::max(vlo, v);
+      }
+      if constexpr(Hi) {
+        v = S::min(vhi, v);
+      }
+      S::store(out + i, v);
+    }
+  }
+  for(; i < n; i++) {
+    T v = in[i];
+    if constexpr(Lo) {
+      v = (v < lo) ? lo : v;
+    }
+    if constexpr(Hi) {
+      v = (v > hi) ? hi : v;
+    }
+    out[i] = v;
+  }
+}
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Clamps an array of values within the inclusive range [lo, hi].
+ *
+ * The array is processed with SSE/AVX min/max instructions when available for T (float, double,
+ * and 8/16/32-bit integers), and with scalar code for the remaining elements.
+ * The input and output may be the same array to clamp in place.
+ *
+ * @tparam T The type of the values and the bounds.
+ * @param in Pointer to the input values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ */
+template <class T>
+void clamp(const T *in, T *out, const std::size_t n, const detail::type_identity_t<T> lo, const detail::type_identity_t<T> hi) {
+  detail::clamp_kernel<true, true>(in, out, n, lo, hi);
+}
+
+/**
+ * @brief Clamps an array of values to be not less than a specified lower bound.
+ *
+ * @tparam T The type of the values and the lower bound.
+ * @param in Pointer to the input values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ * @param lo The lower bound.
+ * @see clamp(const T *in, T *out, const std::size_t n, const detail::type_identity_t<T> lo, const detail::type_identity_t<T> hi)
+ */
+template <class T>
+void clampl(const T *in, T *out, const std::size_t n, const detail::type_identity_t<T> lo) {
+  detail::clamp_kernel<true, false>(in, out, n, lo, lo);
+}
+
+/**
+ * @brief Clamps an array of values to be not greater than a specified upper bound.
+ *
+ * @tparam T The type of the values and the upper bound.
+ * @param in Pointer to the input values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ * @param hi The upper bound.
+ * @see clamp(const T *in, T *out, const std::size_t n, const detail::type_identity_t<T> lo, const detail::type_identity_t<T> hi)
+ */
+template <class T>
+void clamph(const T *in, T *out, const std::size_t n, const detail::type_identity_t<T> hi) {
+  detail::clamp_kernel<false, true>(in, out, n, hi, hi);
+}
+
+/*! \cond INTERNAL */
+namespace detail {
+
+template <typename T, typename U>
+constexpr bool cmp_less(const T t, const U u) {
+  if constexpr(std::is_signed_v<T> == std::is_signed_v<U>) {
+    return t < u;
+  } else if constexpr(std::is_signed_v<T>) {
+    return t < 0 || static_cast<std::make_unsigned_t<T>>(t) < u;
+  } else {
+    return u >= 0 && t < static_cast<std::make_unsigned_t<U>>(u);
+  }
+}
+
+template <typename T>
+constexpr long long round_even(const T x) {
+  const auto t = static_cast<long long>(x);
+  const T d = x - static_cast<T>(t);
+  const bool tie = (d == T(0.5)) || (d == T(-0.5));
+  const long long away = (d > 0) ? 1 : -1;
+  return t + ((d > T(0.5)) - (d < T(-0.5))) + (tie && (t & 1)) * away;
+}
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Converts a value to another arithmetic type, saturating it to the range of the destination type.
+ *
+ * Floating-point values are rounded to the nearest integer (ties to even) and NaN is converted to zero.
+ *
+ * @tparam To The destination type.
+ * @tparam From The source type.
+ * @param x The value to convert.
+ * @return The converted value.
+ *
+ * @example
+ * @code
+ * std::uint8_t a = rush::saturate_cast<std::uint8_t>(300);    // a is 255
+ * std::uint8_t b = rush::saturate_cast<std::uint8_t>(-12.7f); // b is 0
+ * @endcode
+ */
+template <class To, class From>
+[[nodiscard]] constexpr To saturate_cast(const From x) {
+  static_assert(std::is_arithmetic_v<To> && std::is_arithmetic_v<From>);
+  constexpr To lo = std::numeric_limits<To>::lowest();
+  constexpr To hi = std::numeric_limits<To>::max();
+  if constexpr(std::is_floating_point_v<To> || std::is_same_v<To, bool>) {
+    return static_cast<To>(x);
+  } else if constexpr(std::is_floating_point_v<From>) {
+    if(!(x == x)) {
+      return 0;
+    }
+    if(x <= static_cast<From>(lo)) {
+      return lo;
+    }
+    if(x >= static_cast<From>(hi)) {
+      return hi;
+    }
+    if constexpr(std::is_unsigned_v<To> && sizeof(To) >= sizeof(long long)) {
+      if(x >= static_cast<From>(std::numeric_limits<long long>::max())) {
+        return static_cast<To>(x);
+      }
+    }
+    return static_cast<To>(detail::round_even(x));
+  } else {
+    return detail::cmp_less(x, lo) ? lo : detail::cmp_less(hi, x) ? hi : static_cast<To>(x);
+  }
+}
+
+/**
+ * @brief Adds two values, saturating the result to the range of the type.
+ *
+ * @tparam T The type of the values.
+ * @param a The first value.
+ * @param b The second value.
+ * @return The saturated sum.
+ */
+template <class T>
+[[nodiscard]] constexpr T add_sat(const T a, const T b) {
+  if constexpr(std::is_floating_point_v<T>) {
+    return a + b;
+  } else {
+    T r{};
+    const bool overflow = __builtin_add_overflow(a, b, &r);
+    const T limit = (std::is_signed_v<T> && b < 0) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    return overflow ? limit : r;
+  }
+}
+
+/**
+ * @brief Subtracts two values, saturating the result to the range of the type.
+ *
+ * @tparam T The type of the values.
+ * @param a The first value.
+ * @param b The value to subtract.
+ * @return The saturated difference.
+ */
+template <class T>
+[[nodiscard]] constexpr T sub_sat(const T a, const T b) {
+  if constexpr(std::is_floating_point_v<T>) {
+    return a - b;
+  } else {
+    T r{};
+    const bool overflow = __builtin_sub_overflow(a, b, &r);
+    const T limit = (std::is_signed_v<T> && b < 0) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+    return overflow ? limit : r;
+  }
+}
+
+/**
+ * @brief Multiplies two values, saturating the result to the range of the type.
+ *
+ * @tparam T The type of the values.
+ * @param a The first value.
+ * @param b The second value.
+ * @return The saturated product.
+ */
+template <class T>
+[[nodiscard]] constexpr T mul_sat(const T a, const T b) {
+  if constexpr(std::is_floating_point_v<T>) {
+    return a * b;
+  } else {
+    T r{};
+    const bool overflow = __builtin_mul_overflow(a, b, &r);
+    const T limit = (std::is_signed_v<T> && ((a < 0) != (b < 0))) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    return overflow ? limit : r;
+  }
+}
+
+/*! \cond INTERNAL */
+namespace detail {
+
+template <typename From, typename To>
+struct SimdPack {
+  static constexpr std::size_t width = 0;
+};
+
+#if defined(__SSE2__)
+template <typename To>
+struct SimdPackFloat {
+  static constexpr std::size_t width = 16;
+  static void convert(const float *in, To *out) {
+    const __m128 lo = _mm_set1_ps(static_cast<float>(std::numeric_limits<To>::min()));
+    const __m128 hi = _mm_set1_ps(static_cast<float>(std::numeric_limits<To>::max()));
+    __m128i v[4];
+    for(int k = 0; k < 4; k++) {
+      const __m128 x = _mm_loadu_ps(in + 4 * k);
+      v[k] = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_and_ps(x, _mm_cmpord_ps(x, x)), lo), hi));
+    }
+    const __m128i a = _mm_packs_epi32(v[0], v[1]);
+    const __m128i b = _mm_packs_epi32(v[2], v[3]);
+    if constexpr(sizeof(To) == 1) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), std::is_signed_v<To> ? _mm_packs_epi16(a, b) : _mm_packus_epi16(a, b));
+    } else {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), a);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), b);
+    }
+  }
+};
+
+template <>
+struct SimdPack<float, std::uint8_t> : SimdPackFloat<std::uint8_t> {};
+template <>
+struct SimdPack<float, std::int8_t> : SimdPackFloat<std::int8_t> {};
+template <>
+struct SimdPack<float, std::int16_t> : SimdPackFloat<std::int16_t> {};
+
+template <typename To>
+struct SimdPackInt32 {
+  static constexpr std::size_t width = 16;
+  static void convert(const std::int32_t *in, To *out) {
+    const __m128i *p = reinterpret_cast<const __m128i *>(in);
+    const __m128i a = _mm_packs_epi32(_mm_loadu_si128(p), _mm_loadu_si128(p + 1));
+    const __m128i b = _mm_packs_epi32(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3));
+    if constexpr(sizeof(To) == 1) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), std::is_signed_v<To> ? _mm_packs_epi16(a, b) : _mm_packus_epi16(a, b));
+    } else {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), a);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), b);
+    }
+  }
+};
+
+template <>
+struct SimdPack<std::int32_t, std::uint8_t> : SimdPackInt32<std::uint8_t> {};
+template <>
+struct SimdPack<std::int32_t, std::int8_t> : SimdPackInt32<std::int8_t> {};
+template <>
+struct SimdPack<std::int32_t, std::int16_t> : SimdPackInt32<std::int16_t> {};
+
+template <typename To>
+struct SimdPackInt16 {
+  static constexpr std::size_t width = 16;
+  static void convert(const std::int16_t *in, To *out) {
+    const __m128i *p = reinterpret_cast<const __m128i *>(in);
+    const __m128i a = _mm_loadu_si128(p);
+    const __m128i b = _mm_loadu_si128(p + 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), std::is_signed_v<To> ? _mm_packs_epi16(a, b) : _mm_packus_epi16(a, b));
+  }
+};
+
+template <>
+struct SimdPack<std::int16_t, std::uint8_t> : SimdPackInt16<std::uint8_t> {};
+template <>
+struct SimdPack<std::int16_t, std::int8_t> : SimdPackInt16<std::int8_t> {};
+#endif
+
+#if defined(__SSE4_1__)
+template <>
+struct SimdPack<float, std::uint16_t> {
+  static constexpr std::size_t width = 8;
+  static void convert(const float *in, std::uint16_t *out) {
+    const __m128 hi = _mm_set1_ps(65535.0F);
+    const __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in), _mm_setzero_ps()), hi));
+    const __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + 4), _mm_setzero_ps()), hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi32(a, b));
+  }
+};
+
+template <>
+struct SimdPack<std::int32_t, std::uint16_t> {
+  static constexpr std::size_t width = 8;
+  static void convert(const std::int32_t *in, std::uint16_t *out) {
+    const __m128i *p = reinterpret_cast<const __m128i *>(in);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi32(_mm_loadu_si128(p), _mm_loadu_si128(p + 1)));
+  }
+};
+#endif
+
+template <typename T>
+struct SimdSat {
+  static constexpr std::size_t width = 1;
+};
+
+#if defined(__SSE2__)
+#define DEFINE_SIMD_SAT_MACRO(type, suffix)                                                      \
+  template <>                                                                                    \
+  struct SimdSat<type> {                                                                         \
+    static constexpr std::size_t width = 16 / sizeof(type);                                      \
+    static __m128i load(const type *p) {                                                         \
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));                              \
+    }                                                                                            \
+    static void store(type *p, const __m128i v) {                                                \
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);                                       \
+    }                                                                                            \
+    static __m128i add(const __m128i a, const __m128i b) {                                       \
+      return _mm_adds_##suffix(a, b);                                                            \
+    }                                                                                            \
+    static __m128i sub(const __m128i a, const __m128i b) {                                       \
+      return _mm_subs_##suffix(a, b);                                                            \
+    }                                                                                            \
+  };
+
+DEFINE_SIMD_SAT_MACRO(std::int8_t, epi8)
+DEFINE_SIMD_SAT_MACRO(std::uint8_t, epu8)
+DEFINE_SIMD_SAT_MACRO(std::int16_t, epi16)
+DEFINE_SIMD_SAT_MACRO(std::uint16_t, epu16)
+#undef DEFINE_SIMD_SAT_MACRO
+#endif
+
+template <typename T>
+struct SimdMulSat {
+  static constexpr std::size_t width = 1;
+};
+
+#if defined(__SSE2__)
+template <>
+struct SimdMulSat<std::int8_t> {
+  static constexpr std::size_t width = 16;
+  static void mul(const std::int8_t *a, const std::int8_t *b, std::int8_t *out) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    const __m128i lo = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8), _mm_srai_epi16(_mm_unpacklo_epi8(y, y), 8));
+    const __m128i hi = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8), _mm_srai_epi16(_mm_unpackhi_epi8(y, y), 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packs_epi16(lo, hi));
+  }
+};
+
+template <>
+struct SimdMulSat<std::int16_t> {
+  static constexpr std::size_t width = 8;
+  static void mul(const std::int16_t *a, const std::int16_t *b, std::int16_t *out) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    const __m128i lo = _mm_mullo_epi16(x, y);
+    const __m128i hi = _mm_mulhi_epi16(x, y);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packs_epi32(_mm_unpacklo_epi16(lo, hi), _mm_unpackhi_epi16(lo, hi)));
+  }
+};
+#endif
+
+#if defined(__SSE4_1__)
+template <>
+struct SimdMulSat<std::uint8_t> {
+  static constexpr std::size_t width = 16;
+  static void mul(const std::uint8_t *a, const std::uint8_t *b, std::uint8_t *out) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(0xFF);
+    const __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero));
+    const __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(_mm_min_epu16(lo, max), _mm_min_epu16(hi, max)));
+  }
+};
+
+template <>
+struct SimdMulSat<std::uint16_t> {
+  static constexpr std::size_t width = 8;
+  static void mul(const std::uint16_t *a, const std::uint16_t *b, std::uint16_t *out) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    const __m128i max = _mm_set1_epi32(0xFFFF);
+    const __m128i lo = _mm_mullo_epi16(x, y);
+    const __m128i hi = _mm_mulhi_epu16(x, y);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi32(_mm_min_epu32(_mm_unpacklo_epi16(lo, hi), max), _mm_min_epu32(_mm_unpackhi_epi16(lo, hi), max)));
+  }
+};
+#endif
+
+template <bool Add, typename T>
+void sat_kernel(const T *a, const T *b, T *out, const std::size_t n) {
+  std::size_t i = 0;
+  if constexpr(SimdSat<T>::width > 1) {
+    using S = SimdSat<T>;
+    for(; i + S::width <= n; i += S::width) {
+      S::store(out + i, Add ? S::add(S::load(a + i), S::load(b + i)) : S::sub(S::load(a + i), S::load(b + i)));
+    }
+  }
+  for(; i < n; i++) {
+    out[i] = Add ? add_sat(a[i], b[i]) : sub_sat(a[i], b[i]);
+  }
+}
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Converts an array of values to another arithmetic type, saturating them to the range of the destination type.
+ *
+ * Conversions from float, int32 and int16 into 8/16-bit integers use SSE pack-with-saturation instructions,
+ * so clamping and narrowing are performed in a single pass. Other conversions use scalar code.
+ *
+ * @tparam To The destination type.
+ * @tparam From The source type.
+ * @param in Pointer to the input values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ * @see saturate_cast(const From x)
+ */
+template <class To, class From>
+void saturate_cast(const From *in, To *out, const std::size_t n) {
+  std::size_t i = 0;
+  if constexpr(detail::SimdPack<From, To>::width > 0) {
+    using P = detail::SimdPack<From, To>;
+    for(; i + P::width <= n; i += P::width) {
+      P::convert(in + i, out + i);
+    }
+  }
+  for(; i < n; i++) {
+    out[i] = saturate_cast<To>(in[i]);
+  }
+}
+
+/**
+ * @brief Adds two arrays of values element-wise, saturating the results to the range of the type.
+ *
+ * 8-bit and 16-bit integers use SSE saturating instructions. The output may alias any of the inputs.
+ *
+ * @tparam T The type of the values.
+ * @param a Pointer to the first values.
+ * @param b Pointer to the second values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ */
+template <class T>
+void add_sat(const T *a, const T *b, T *out, const std::size_t n) {
+  detail::sat_kernel<true>(a, b, out, n);
+}
+
+/**
+ * @brief Subtracts two arrays of values element-wise, saturating the results to the range of the type.
+ *
+ * 8-bit and 16-bit integers use SSE saturating instructions. The output may alias any of the inputs.
+ *
+ * @tparam T The type of the values.
+ * @param a Pointer to the first values.
+ * @param b Pointer to the values to subtract.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ */
+template <class T>
+void sub_sat(const T *a, const T *b, T *out, const std::size_t n) {
+  detail::sat_kernel<false>(a, b, out, n);
+}
+
+/**
+ * @brief Multiplies two arrays of values element-wise, saturating the results to the range of the type.
+ *
+ * 8-bit and 16-bit integers use SSE instructions (SSE4.1 for unsigned types): products are computed at twice
+ * the width and packed back with saturation. The output may alias any of the inputs.
+ *
+ * @tparam T The type of the values.
+ * @param a Pointer to the first values.
+ * @param b Pointer to the second values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ */
+template <class T>
+void mul_sat(const T *a, const T *b, T *out, const std::size_t n) {
+  std::size_t i = 0;
+  if constexpr(detail::SimdMulSat<T>::width > 1) {
+    using S = detail::SimdMulSat<T>;
+    for(; i + S::width <= n; i += S::width) {
+      S::mul(a + i, b + i, out + i);
+    }
+  }
+  for(; i < n; i++) {
+    out[i] = mul_sat(a[i], b[i]);
+  }
+}
+
+#if __cplusplus >= 202002L
+/**
+ * @brief Clamps a span of values within the inclusive range [lo, hi].
+ *
+ * @tparam T The type of the values and the bounds.
+ * @param in The input values.
+ * @param out The output values. It must have at least as many elements as the input.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ */
+template <class T>
+void clamp(std::span<const std::type_identity_t<T>> in, std::span<T> out, const std::type_identity_t<T> lo, const std::type_identity_t<T> hi) {
+  clamp(in.data(), out.data(), in.size(), lo, hi);
+}
+
+/**
+ * @brief Clamps a span of values within the inclusive range [lo, hi] in place.
+ *
+ * @tparam T The type of the values and the bounds.
+ * @param x The values.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ */
+template <class T>
+void clamp(std::span<T> x, const std::type_identity_t<T> lo, const std::type_identity_t<T> hi) {
+  clamp(x.data(), x.data(), x.size(), lo, hi);
+}
+
+/**
+ * @brief Clamps a span of values to be not less than a specified lower bound.
+ *
+ * @tparam T The type of the values and the lower bound.
+ * @param in The input values.
+ * @param out The output values. It must have at least as many elements as the input.
+ * @param lo The lower bound.
+ */
+template <class T>
+void clampl(std::span<const std::type_identity_t<T>> in, std::span<T> out, const std::type_identity_t<T> lo) {
+  clampl(in.data(), out.data(), in.size(), lo);
+}
+
+/**
+ * @brief Clamps a span of values to be not greater than a specified upper bound.
+ *
+ * @tparam T The type of the values and the upper bound.
+ * @param in The input values.
+ * @param out The output values. It must have at least as many elements as the input.
+ * @param hi The upper bound.
+ */
+template <class T>
+void clamph(std::span<const std::type_identity_t<T>> in, std::span<T> out, const std::type_identity_t<T> hi) {
+  clamph(in.data(), out.data(), in.size(), hi);
+}
+
+/**
+ * @brief Converts a span of values to another arithmetic type, saturating them to the range of the destination type.
+ *
+ * @tparam To The destination type.
+ * @tparam From The source type.
+ * @param in The input values.
+ * @param out The output values. It must have at least as many elements as the input.
+ */
+template <class To, class From>
+void saturate_cast(std::span<From> in, std::span<To> out) {
+  saturate_cast(in.data(), out.data(), in.size());
+}
+
+/**
+ * @brief Adds two spans of values element-wise, saturating the results to the range of the type.
+ *
+ * @tparam T The type of the values.
+ * @param a The first values.
+ * @param b The second values. It must have at least as many elements as the first.
+ * @param out The output values. It must have at least as many elements as the first.
+ */
+template <class T>
+void add_sat(std::span<const std::type_identity_t<T>> a, std::span<const std::type_identity_t<T>> b, std::span<T> out) {
+  add_sat(a.data(), b.data(), out.data(), a.size());
+}
+
+/**
+ * @brief Subtracts two spans of values element-wise, saturating the results to the range of the type.
+ *
+ * @tparam T The type of the values.
+ * @param a The first values.
+ * @param b The values to subtract. It must have at least as many elements as the first.
+ * @param out The output values. It must have at least as many elements as the first.
+ */
+template <class T>
+void sub_sat(std::span<const std::type_identity_t<T>> a, std::span<const std::type_identity_t<T>> b, std::span<T> out) {
+  sub_sat(a.data(), b.data(), out.data(), a.size());
+}
+
+/**
+ * @brief Multiplies two spans of values element-wise, saturating the results to the range of the type.
+ *
+ * @tparam T The type of the values.
+ * @param a The first values.
+ * @param b The second values. It must have at least as many elements as the first.
+ * @param out The output values. It must have at least as many elements as the first.
+ */
+template <class T>
+void mul_sat(std::span<const std::type_identity_t<T>> a, std::span<const std::type_identity_t<T>> b, std::span<T> out) {
+  mul_sat(a.data(), b.data(), out.data(), a.size());
+}
+#endif
+
+/*! \cond INTERNAL */
+namespace detail {
+
+#if defined(__SSE2__)
+inline bool small_sort(const float *in, const std::size_t n, float *out) {
+  alignas(16) float v[16];
+  std::fill(std::copy(in, in + n, v), v + 16, std::numeric_limits<float>::infinity());
+  __m128 lanes[4];
+  __m128i index[4];
+  int unordered = 0;
+  for(int q = 0; q < 4; q++) {
+    lanes[q] = _mm_load_ps(v + 4 * q);
+    index[q] = _mm_setr_epi32(4 * q, 4 * q + 1, 4 * q + 2, 4 * q + 3);
+    unordered |= _mm_movemask_ps(_mm_cmpunord_ps(lanes[q], lanes[q]));
+  }
+  if(unordered != 0) {
+    return false;
+  }
+  for(std::size_t i = 0; i < n; i++) {
+    const __m128 x = _mm_set1_ps(v[i]);
+    const __m128i before = _mm_set1_epi32(static_cast<int>(i));
+    int rank = 0;
+    for(int q = 0; q < 4; q++) {
+      const __m128 tie = _mm_and_ps(_mm_cmpeq_ps(lanes[q], x), _mm_castsi128_ps(_mm_cmplt_epi32(index[q], before)));
+      rank += __builtin_popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(lanes[q], x), tie))));
+    }
+    out[rank] = v[i];
+  }
+  return true;
+}
+
+template <typename Compare>
+constexpr bool small_sort_applies = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<float>> || std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<float>>;
+#endif
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Top-k selection strategy.
+ */
+enum class SelectStrategy : std::uint8_t {
+  automatic,  ///< Choose the strategy from the input size and k.
+  heap,       ///< Keep a heap of k elements while scanning the input: O(n log k) time and O(k) memory.
+  introselect ///< Partition a copy of the input with introselect and sort the first k elements: O(n + k log k) time and O(n) memory.
+};
+
+/**
+ * @brief Get the k best elements of an array, best first.
+ *
+ * Small float arrays (up to 16 elements, without NaNs) ordered with std::less or std::greater are sorted
+ * with an SSE rank-counting network. Otherwise, the selected strategy is used.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Compare The type of the comparison.
+ * @param in Pointer to the input elements.
+ * @param n The number of input elements.
+ * @param k The number of elements to select. It is clamped to n.
+ * @param comp Comparison that returns true if the first argument is better than the second (std::greater selects the largest elements).
+ * @param strategy The selection strategy.
+ * @return The k best elements, best first.
+ *
+ * @example
+ * @code
+ * std::vector<float> best = rush::top_k(scores.data(), scores.size(), 5); // Five highest scores
+ * @endcode
+ */
+template <class T, class Compare = std::greater<>>
+std::vector<T> top_k(const T *in, const std::size_t n, std::size_t k, Compare comp = Compare(), const SelectStrategy strategy = SelectStrategy::automatic) {
+  k = std::min(k, n);
+  std::vector<T> out(k);
+#if defined(__SSE2__)
+  if constexpr(std::is_same_v<T, float> && detail::small_sort_applies<Compare>) {
+    if(float sorted[16]; n <= 16 && detail::small_sort(in, n, sorted)) {
+      if(comp(1.0F, 0.0F)) {
+        std::reverse_copy(sorted + n - k, sorted + n, out.begin());
+      } else {
+        std::copy(sorted, sorted + k, out.begin());
+      }
+      return out;
+    }
+  }
+#endif
+  if(strategy == SelectStrategy::heap || (strategy == SelectStrategy::automatic && k < n / 8)) {
+    std::partial_sort_copy(in, in + n, out.begin(), out.end(), comp);
+  } else {
+    std::vector<T> tmp(in, in + n);
+    if(k < n) {
+      std::nth_element(tmp.begin(), tmp.begin() + static_cast<std::ptrdiff_t>(k), tmp.end(), comp);
+    }
+    std::sort(tmp.begin(), tmp.begin() + static_cast<std::ptrdiff_t>(k), comp);
+    std::move(tmp.begin(), tmp.begin() + static_cast<std::ptrdiff_t>(k), out.begin());
+  }
+  return out;
+}
+
+/**
+ * @brief Get the median of an array.
+ *
+ * For an even number of elements, floating-point types return the mean of the two middle elements,
+ * and other types return the lower one. Small float arrays (up to 16 elements, without NaNs) use an SSE path.
+ *
+ * @tparam T The type of the elements.
+ * @param in Pointer to the input elements.
+ * @param n The number of input elements. It must be greater than zero.
+ * @return The median.
+ */
+template <class T>
+T median(const T *in, const std::size_t n) {
+  const std::size_t mid = (n - 1) / 2;
+  const bool mean = std::is_floating_point_v<T> && n % 2 == 0;
+#if defined(__SSE2__)
+  if constexpr(std::is_same_v<T, float>) {
+    if(float sorted[16]; n <= 16 && detail::small_sort(in, n, sorted)) {
+      return mean ? (sorted[mid] + sorted[mid + 1]) / 2 : sorted[mid];
+    }
+  }
+#endif
+  std::vector<T> tmp(in, in + n);
+  std::nth_element(tmp.begin(), tmp.begin() + static_cast<std::ptrdiff_t>(mid), tmp.end());
+  if(mean) {
+    const T upper = *std::min_element(tmp.begin() + static_cast<std::ptrdiff_t>(mid + 1), tmp.end());
+    return (tmp[mid] + upper) / 2;
+  }
+  return tmp[mid];
+}
+
+/**
+ * @brief Keeps the k best elements of a stream using O(k) memory.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Compare The type of the comparison.
+ *
+ * @example
+ * @code
+ * rush::TopK<float> best(10);
+ * for(const Detection &d : detections) {
+ *   best.push(d.score);
+ * }
+ * std::vector<float> scores = best.values();
+ * @endcode
+ */
+template <class T, class Compare = std::greater<>>
+class TopK {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param k The number of elements to keep.
+   * @param comp Comparison that returns true if the first argument is better than the second (std::greater keeps the largest elements).
+   */
+  explicit TopK(const std::size_t k, Compare comp = Compare()) : k_{k}, comp_{std::move(comp)} {
+    heap_.reserve(k_);
+  }
+
+  /**
+   * @brief Add an element to the stream.
+   *
+   * @param x The element.
+   * @return True if the element is currently among the k best.
+   */
+  bool push(const T &x) {
+    if(heap_.size() < k_) {
+      heap_.push_back(x);
+      std::push_heap(heap_.begin(), heap_.end(), comp_);
+      return true;
+    }
+    if(k_ == 0 || !comp_(x, heap_.front())) {
+      return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), comp_);
+    heap_.back() = x;
+    std::push_heap(heap_.begin(), heap_.end(), comp_);
+    return true;
+  }
+
+  /**
+   * @brief Get the worst of the kept elements, which is the threshold a new element must beat.
+   *
+   * @return The worst kept element. The stream must not be empty.
+   */
+  [[nodiscard]] const T &threshold() const {
+    return heap_.front();
+  }
+
+  /**
+   * @brief Get the kept elements.
+   *
+   * @return The kept elements, best first.
+   */
+  [[nodiscard]] std::vector<T> values() const {
+    std::vector<T> ret(heap_);
+    std::sort_heap(ret.begin(), ret.end(), comp_);
+    return ret;
+  }
+
+  /**
+   * @brief Get the number of kept elements.
+   *
+   * @return The number of kept elements, which is at most k.
+   */
+  [[nodiscard]] std::size_t size() const {
+    return heap_.size();
+  }
+
+  /**
+   * @brief Remove all the kept elements.
+   */
+  void clear() {
+    heap_.clear();
+  }
+
+private:
+  std::size_t k_;
+  Compare comp_;
+  std::vector<T> heap_;
+};
+
+#if __cplusplus >= 202002L
+/**
+ * @brief Get the k best elements of a span, best first.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Compare The type of the comparison.
+ * @param in The input elements.
+ * @param k The number of elements to select. It is clamped to the size of the span.
+ * @param comp Comparison that returns true if the first argument is better than the second.
+ * @param strategy The selection strategy.
+ * @return The k best elements, best first.
+ * @see top_k(const T *in, const std::size_t n, std::size_t k, Compare comp, const SelectStrategy strategy)
+ */
+template <class T, class Compare = std::greater<>>
+std::vector<std::remove_cv_t<T>> top_k(std::span<T> in, const std::size_t k, Compare comp = Compare(), const SelectStrategy strategy = SelectStrategy::automatic) {
+  return top_k(in.data(), in.size(), k, std::move(comp), strategy);
+}
+
+/**
+ * @brief Get the median of a span.
+ *
+ * @tparam T The type of the elements.
+ * @param in The input elements. It must not be empty.
+ * @return The median.
+ * @see median(const T *in, const std::size_t n)
+ */
+template <class T>
+std::remove_cv_t<T> median(std::span<T> in) {
+  return median(in.data(), in.size());
+}
+#endif
+
 } // namespace rush
 
 #endif // RUSH_ALGORITHM_HPP
@@ -8,14 +8,67 @@
 #ifndef RUSH_COUNTER_HPP
 #define RUSH_COUNTER_HPP
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <limits>
 #include <utility>
 
 namespace rush {
 
+/**
+ * @brief Assumed size of a cache line, used to keep independently written data on separate lines.
+ */
+inline constexpr std::size_t cache_line_size = 64;
+
+/*! \cond INTERNAL */
+namespace detail {
+inline std::size_t thread_slot() {
+  static std::atomic<std::size_t> next{0};
+  thread_local const std::size_t slot{next.fetch_add(1, std::memory_order_relaxed)};
+  return slot;
+}
+
+template <typename T>
+constexpr T exchange(T &value, const T next) {
+  const T ret = value;
+  value = next;
+  return ret;
+}
+
+template <typename T>
+constexpr T wrap_add(const T value, const T step, const T range) {
+  return (value >= range - step) ? value - (range - step) : value + step;
+}
+
+template <typename T>
+constexpr T wrap_mul(T step, unsigned long n, const T range) {
+  T ret = 0;
+  for(; n != 0; n >>= 1) {
+    if(n & 1) {
+      ret = wrap_add(ret, step, range);
+    }
+    step = wrap_add(step, step, range);
+  }
+  return ret;
+}
+
+template <typename T>
+constexpr T wrap_steps(const T step, const int n, const T range) {
+  if(n >= 0) {
+    return wrap_mul(step, static_cast<unsigned long>(n), range);
+  }
+  const T back = wrap_mul(step, 0UL - static_cast<unsigned long>(n), range);
+  return (back == 0) ? 0 : range - back;
+}
+} // namespace detail
+/*! \endcond */
+
 /**
  * @brief A generic counter class with customizable initial value and step.
  *
+ * The counter is usable in constant expressions.
+ *
  * @tparam T The type of the counter, default is unsigned long.
  */
 template <typename T = unsigned long>
@@ -27,15 +80,15 @@ public:
    * @param init The initial value of the counter.
    * @param step The step value for each increment or decrement.
    */
-  explicit Counter(const T init = 0, const T step = 1) : init_{init}, step_{step}, counter_{init} {}
+  explicit constexpr Counter(const T init = 0, const T step = 1) : init_{init}, step_{step}, counter_{init} {}
 
   /**
    * @brief Increment the counter by the step value and return the previous value.
    *
    * @return The value of the counter before incrementing.
    */
-  T operator()() {
-    return std::exchange(counter_, counter_ + step_);
+  constexpr T operator()() {
+    return detail::exchange(counter_, counter_ + step_);
   }
 
   /**
@@ -43,7 +96,7 @@ public:
    *
    * @return The new value of the counter after incrementing.
    */
-  T operator++() {
+  constexpr T operator++() {
     return counter_ += step_;
   }
 
@@ -52,8 +105,8 @@ public:
    *
    * @return The value of the counter before incrementing.
    */
-  T operator++(int) {
-    return std::exchange(counter_, counter_ + step_);
+  constexpr T operator++(int) {
+    return detail::exchange(counter_, counter_ + step_);
   }
 
   /**
@@ -62,8 +115,8 @@ public:
    * @param n The number of steps to increment.
    * @return The value of the counter after incrementing.
    */
-  T operator+=(const int n) {
-    return std::exchange(counter_, counter_ + n * step_);
+  constexpr T operator+=(const int n) {
+    return detail::exchange(counter_, counter_ + n * step_);
   }
 
   /**
@@ -71,7 +124,7 @@ public:
    *
    * @return The new value of the counter after decrementing.
    */
-  T operator--() {
+  constexpr T operator--() {
     return counter_ -= step_;
   }
 
@@ -80,8 +133,8 @@ public:
    *
    * @return The value of the counter before decrementing.
    */
-  T operator--(int) {
-    return std::exchange(counter_, counter_ - step_);
+  constexpr T operator--(int) {
+    return detail::exchange(counter_, counter_ - step_);
   }
 
   /**
@@ -90,8 +143,8 @@ public:
    * @param n The number of steps to decrement.
    * @return The value of the counter after decrementing.
    */
-  T operator-=(const int n) {
-    return std::exchange(counter_, counter_ - n * step_);
+  constexpr T operator-=(const int n) {
+    return detail::exchange(counter_, counter_ - n * step_);
   }
 
   /**
@@ -99,26 +152,29 @@ public:
    *
    * @param value The value to set the counter to.
    */
-  void set(const T value) {
+  constexpr void set(const T value) {
     counter_ = value;
   }
 
   /**
    * @brief Reset the counter to its initial value.
    */
-  void reset() {
+  constexpr void reset() {
     counter_ = init_;
   }
 
-private:
-  const T init_;
-  const T step_;
+protected:
+  T init_;
+  T step_;
   T counter_;
 };
 
 /**
  * @brief A counter class that resets after reaching a specified limit.
  *
+ * The wrapped value is stored directly and wraps around with a compare-and-subtract,
+ * so no division is performed when the counter is incremented.
+ *
  * @tparam T The type of the counter, default is unsigned long.
  */
 template <typename T = unsigned long>
@@ -128,46 +184,56 @@ public:
    * @brief Constructor.
    *
    * @param init The initial value of the counter.
-   * @param reset The value at which the counter resets to zero.
+   * @param reset The value at which the counter resets to the initial value.
    * @param step The step value for each increment.
    */
-  explicit RangeCounter(const T init = 0, const T reset = std::numeric_limits<T>::max(), const T step = 1) : Counter<T>(0, step), offset_{init}, reset_{reset - init} {}
+  explicit constexpr RangeCounter(const T init = 0, const T reset = std::numeric_limits<T>::max(), const T step = 1) : Counter<T>(0, step % (reset - init)), offset_{init}, reset_{reset - init} {}
 
   /**
-   * @brief Increment the counter by the step value and return the previous value, modulo the reset value.
+   * @brief Increment the counter by the step value and return the previous value, wrapped into the range.
    *
-   * @return The value of the counter before incrementing, modulo the reset value.
+   * @return The value of the counter before incrementing, wrapped into the range.
    */
-  T operator()() {
-    return Counter<T>::operator()() % reset_ + offset_;
+  constexpr T operator()() {
+    return advance(this->step_) + offset_;
   }
 
   /**
-   * @brief Pre-increment the counter by the step value, modulo the reset value.
+   * @brief Pre-increment the counter by the step value, wrapped into the range.
    *
-   * @return The new value of the counter after incrementing, modulo the reset value.
+   * @return The new value of the counter after incrementing, wrapped into the range.
    */
-  T operator++() {
-    return Counter<T>::operator++() % reset_ + offset_;
+  constexpr T operator++() {
+    advance(this->step_);
+    return this->counter_ + offset_;
   }
 
   /**
-   * @brief Post-increment the counter by the step value, modulo the reset value.
+   * @brief Post-increment the counter by the step value, wrapped into the range.
    *
-   * @return The value of the counter before incrementing, modulo the reset value.
+   * @return The value of the counter before incrementing, wrapped into the range.
    */
-  T operator++(int) {
-    return Counter<T>::operator++(0) % reset_ + offset_;
+  constexpr T operator++(int) {
+    return advance(this->step_) + offset_;
   }
 
   /**
-   * @brief Increment the counter by n steps, modulo the reset value.
+   * @brief Increment the counter by n steps, wrapped into the range.
    *
    * @param n The number of steps to increment.
-   * @return The value of the counter after incrementing, modulo the reset value.
+   * @return The value of the counter before incrementing, wrapped into the range.
    */
-  T operator+=(const int n) {
-    return Counter<T>::operator+=(n) % reset_ + offset_;
+  constexpr T operator+=(const int n) {
+    return advance(detail::wrap_steps(this->step_, n, reset_)) + offset_;
+  }
+
+  /**
+   * @brief Set the counter to a specific value.
+   *
+   * @param value The value to set the counter to. It is wrapped into the range.
+   */
+  constexpr void set(const T value) {
+    this->counter_ = value % reset_;
   }
 
   /*! \cond INTERNAL */
@@ -177,8 +243,429 @@ public:
   /*! \endcond */
 
 private:
+  constexpr T advance(const T step) {
+    const T ret = this->counter_;
+    this->counter_ = detail::wrap_add(this->counter_, step, reset_);
+    return ret;
+  }
+
+  T offset_;
+  T reset_;
+};
+
+/**
+ * @brief A counter class that resets after reaching a limit known at compile time.
+ *
+ * When the range is a power of two, the counter wraps around with a bitmask.
+ * Otherwise, it uses a compare-and-subtract like RangeCounter.
+ *
+ * @tparam T The type of the counter.
+ * @tparam Init The initial value of the counter.
+ * @tparam Reset The value at which the counter resets to the initial value.
+ * @tparam Step The step value for each increment.
+ *
+ * @example
+ * @code
+ * rush::FixedRangeCounter<std::size_t, 0, 1024> index; // Wraps around with a bitmask
+ * @endcode
+ */
+template <typename T, T Init, T Reset, T Step = 1>
+class FixedRangeCounter {
+  static_assert(Reset > Init, "Reset must be greater than Init");
+
+public:
+  static constexpr T range = Reset - Init;                        ///< Number of values in the range.
+  static constexpr bool power_of_two = (range & (range - 1)) == 0; ///< Whether the range is a power of two.
+
+  constexpr FixedRangeCounter() = default;
+
+  /**
+   * @brief Increment the counter by the step value and return the previous value.
+   *
+   * @return The value of the counter before incrementing.
+   */
+  constexpr T operator()() {
+    return advance(step) + Init;
+  }
+
+  /**
+   * @brief Pre-increment the counter by the step value.
+   *
+   * @return The new value of the counter after incrementing.
+   */
+  constexpr T operator++() {
+    advance(step);
+    return counter_ + Init;
+  }
+
+  /**
+   * @brief Post-increment the counter by the step value.
+   *
+   * @return The value of the counter before incrementing.
+   */
+  constexpr T operator++(int) {
+    return advance(step) + Init;
+  }
+
+  /**
+   * @brief Increment the counter by n steps.
+   *
+   * @param n The number of steps to increment.
+   * @return The value of the counter before incrementing.
+   */
+  constexpr T operator+=(const int n) {
+    if constexpr(power_of_two) {
+      return advance(static_cast<T>(static_cast<T>(n) * step)) + Init;
+    } else {
+      return advance(detail::wrap_steps(step, n, range)) + Init;
+    }
+  }
+
+  /**
+   * @brief Set the counter to a specific value.
+   *
+   * @param value The value to set the counter to. It is wrapped into the range.
+   */
+  constexpr void set(const T value) {
+    counter_ = power_of_two ? (value & (range - 1)) : (value % range);
+  }
+
+  /**
+   * @brief Reset the counter to its initial value.
+   */
+  constexpr void reset() {
+    counter_ = 0;
+  }
+
+private:
+  static constexpr T step = Step % range;
+
+  constexpr T advance(const T s) {
+    const T ret = counter_;
+    if constexpr(power_of_two) {
+      counter_ = (counter_ + s) & (range - 1);
+    } else {
+      counter_ = detail::wrap_add(counter_, s, range);
+    }
+    return ret;
+  }
+
+  T counter_{0};
+};
+
+/**
+ * @brief Materialize the next N values of a counter into an array.
+ *
+ * The counter is taken by value, so the caller's counter is not modified.
+ * When used in a constant expression, the table is generated at compile time.
+ *
+ * @tparam N The number of values.
+ * @tparam C The type of the counter (e.g., Counter, RangeCounter or FixedRangeCounter).
+ * @param counter The counter that generates the sequence.
+ * @return An array containing the sequence.
+ *
+ * @example
+ * @code
+ * constexpr auto table = rush::sequence<6>(rush::RangeCounter<int>(0, 3)); // {0, 1, 2, 0, 1, 2}
+ * @endcode
+ */
+template <std::size_t N, typename C>
+constexpr auto sequence(C counter) {
+  std::array<decltype(counter()), N> ret{};
+  for(std::size_t i = 0; i < N; i++) {
+    ret[i] = counter();
+  }
+  return ret;
+}
+
+/**
+ * @brief A thread-safe counter class with customizable initial value and step.
+ *
+ * All operations are performed with a single relaxed atomic read-modify-write,
+ * so concurrent callers always obtain distinct values but no ordering with other memory is implied.
+ *
+ * @tparam T The type of the counter, default is unsigned long. It must be an integral type.
+ */
+template <typename T = unsigned long>
+class AtomicCounter {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param init The initial value of the counter.
+   * @param step The step value for each increment or decrement.
+   */
+  explicit AtomicCounter(const T init = 0, const T step = 1) : init_{init}, step_{step}, counter_{init} {}
+
+  /**
+   * @brief Increment the counter by the step value and return the previous value.
+   *
+   * @return The value of the counter before incrementing.
+   */
+  T operator()() {
+    return counter_.fetch_add(step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pre-increment the counter by the step value.
+   *
+   * @return The new value of the counter after incrementing.
+   */
+  T operator++() {
+    return counter_.fetch_add(step_, std::memory_order_relaxed) + step_;
+  }
+
+  /**
+   * @brief Post-increment the counter by the step value.
+   *
+   * @return The value of the counter before incrementing.
+   */
+  T operator++(int) {
+    return counter_.fetch_add(step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Increment the counter by n steps.
+   *
+   * @param n The number of steps to increment.
+   * @return The value of the counter before incrementing.
+   */
+  T operator+=(const int n) {
+    return counter_.fetch_add(n * step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pre-decrement the counter by the step value.
+   *
+   * @return The new value of the counter after decrementing.
+   */
+  T operator--() {
+    return counter_.fetch_sub(step_, std::memory_order_relaxed) - step_;
+  }
+
+  /**
+   * @brief Post-decrement the counter by the step value.
+   *
+   * @return The value of the counter before decrementing.
+   */
+  T operator--(int) {
+    return counter_.fetch_sub(step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Decrement the counter by n steps.
+   *
+   * @param n The number of steps to decrement.
+   * @return The value of the counter before decrementing.
+   */
+  T operator-=(const int n) {
+    return counter_.fetch_sub(n * step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the current value of the counter without modifying it.
+   *
+   * @return The current value of the counter.
+   */
+  [[nodiscard]] T value() const {
+    return counter_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Set the counter to a specific value.
+   *
+   * @param value The value to set the counter to.
+   */
+  void set(const T value) {
+    counter_.store(value, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Reset the counter to its initial value.
+   */
+  void reset() {
+    counter_.store(init_, std::memory_order_relaxed);
+  }
+
+private:
+  const T init_;
+  const T step_;
+  std::atomic<T> counter_;
+};
+
+/**
+ * @brief A thread-safe counter optimized for frequent concurrent increments and infrequent reads.
+ *
+ * Each thread increments its own cache-line-padded cell, so increments from different threads
+ * do not contend on the same cache line. Reading the value aggregates all cells.
+ *
+ * @tparam T The type of the counter, default is unsigned long. It must be an integral type.
+ * @tparam Shards The number of cells. Threads beyond this number share cells.
+ */
+template <typename T = unsigned long, std::size_t Shards = 64>
+class ShardedCounter {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param init The initial value of the counter.
+   * @param step The step value for each increment.
+   */
+  explicit ShardedCounter(const T init = 0, const T step = 1) : init_{init}, step_{step} {}
+
+  /**
+   * @brief Increment the counter by the step value.
+   */
+  void operator++() {
+    cell().fetch_add(step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Increment the counter by the step value.
+   */
+  void operator++(int) {
+    cell().fetch_add(step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Increment the counter by n steps.
+   *
+   * @param n The number of steps to increment.
+   */
+  void operator+=(const int n) {
+    cell().fetch_add(n * step_, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Aggregate all cells into the current value of the counter.
+   *
+   * @return The current value of the counter.
+   * @note Increments performed concurrently with this call may or may not be included.
+   */
+  [[nodiscard]] T value() const {
+    T sum = init_;
+    for(const Cell &c : cells_) {
+      sum += c.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  /**
+   * @brief Reset the counter to its initial value.
+   *
+   * @note Increments performed concurrently with this call may or may not be discarded.
+   */
+  void reset() {
+    for(Cell &c : cells_) {
+      c.value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  struct alignas(cache_line_size) Cell {
+    std::atomic<T> value{0};
+  };
+
+  std::atomic<T> &cell() {
+    return cells_[detail::thread_slot() % Shards].value;
+  }
+
+  const T init_;
+  const T step_;
+  std::array<Cell, Shards> cells_{};
+};
+
+/**
+ * @brief A thread-safe counter that hands out values in blocks to reduce contention.
+ *
+ * Each thread obtains a BlockCounter::Local handle, which reserves a block of consecutive values
+ * from the shared position, which is kept wrapped into the range with a compare-and-swap loop,
+ * and then hands them out without synchronization.
+ * Values follow the same sequence as RangeCounter, including the wraparound at the reset value,
+ * and are unique across threads until the sequence wraps around.
+ *
+ * @tparam T The type of the counter, default is unsigned long. It must be an unsigned integral type.
+ *
+ * @example
+ * @code
+ * rush::BlockCounter<> ids(4096);
+ * // In each thread:
+ * rush::BlockCounter<>::Local local = ids.local();
+ * unsigned long id = local();
+ * @endcode
+ */
+template <typename T = unsigned long>
+class BlockCounter {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param block The number of values reserved at once by each thread.
+   * @param init The initial value of the counter.
+   * @param reset The value at which the counter resets to the initial value.
+   * @param step The step value for each increment.
+   */
+  explicit BlockCounter(const T block = 1024, const T init = 0, const T reset = std::numeric_limits<T>::max(), const T step = 1) : block_{block}, offset_{init}, reset_{static_cast<T>(reset - init)}, step_{static_cast<T>(step % (reset - init))}, stride_{detail::wrap_mul(step_, static_cast<unsigned long>(block), reset_)} {}
+
+  /**
+   * @brief A per-thread handle that hands out the values of the reserved block.
+   *
+   * @note A handle must not be shared between threads.
+   */
+  class Local {
+  public:
+    /**
+     * @brief Constructor.
+     *
+     * @param shared The shared counter from which blocks are reserved.
+     */
+    explicit Local(BlockCounter &shared) : shared_{&shared} {}
+
+    /**
+     * @brief Get the next value, reserving a new block if the current one is exhausted.
+     *
+     * @return The next value of the sequence.
+     */
+    T operator()() {
+      if(remaining_ == 0) {
+        current_ = shared_->reserve();
+        remaining_ = shared_->block_;
+      }
+      --remaining_;
+      const T ret = current_;
+      current_ = detail::wrap_add(current_, shared_->step_, shared_->reset_);
+      return ret + shared_->offset_;
+    }
+
+  private:
+    BlockCounter *shared_;
+    T current_{0};
+    T remaining_{0};
+  };
+
+  /**
+   * @brief Create a handle to be used by the calling thread.
+   *
+   * @return A new handle with no reserved block.
+   */
+  Local local() {
+    return Local(*this);
+  }
+
+private:
+  const T block_;
   const T offset_;
   const T reset_;
+  const T step_;
+  const T stride_;
+  std::atomic<T> position_{0};
+
+  T reserve() {
+    T pos = position_.load(std::memory_order_relaxed);
+    while(!position_.compare_exchange_weak(pos, detail::wrap_add(pos, stride_, reset_), std::memory_order_relaxed)) {
+    }
+    return pos;
+  }
 };
 
 } // namespace rush
@@ -8,52 +8,448 @@
 #ifndef RUSH_CV_HIGHGUI_HPP
 #define RUSH_CV_HIGHGUI_HPP
 
+#include "rush/ring-buffer.hpp"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <opencv2/core.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/mat.inl.hpp>
 #include <opencv2/core/types.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace rush::cv {
 
 /**
- * @brief Create a montage from a matrix of images.
+ * @brief Enumeration for how each image is placed in its montage cell.
+ */
+enum class MontageLayout : std::uint8_t {
+  stretch,  ///< Resize to the cell size, ignoring the aspect ratio.
+  fit,      ///< Preserve the aspect ratio and place the image at the top-left corner of the cell.
+  fill,     ///< Preserve the aspect ratio and crop the image so that it covers the whole cell.
+  letterbox ///< Preserve the aspect ratio and center the image in the cell, with bars around it.
+};
+
+/**
+ * @brief Configuration structure for montages.
+ */
+struct MontageConfiguration {
+  int type{-1};                                         ///< Type of the montage (e.g., CV_8UC3). If negative, the common type of the inputs is used, or 8-bit with the largest number of channels if they differ.
+  bool parallel{true};                                  ///< Whether to process the tiles in parallel with cv::parallel_for_.
+  MontageLayout layout{MontageLayout::stretch};         ///< How each image is placed in its cell.
+  ::cv::Size size{};                                    ///< Size of the montage. If empty, every cell takes the size of the smallest image.
+  int interpolation{-1};                                ///< Interpolation method. If negative, INTER_AREA is used for tiles that are downscaled and INTER_LINEAR otherwise.
+  ::cv::Scalar background{::cv::Scalar::all(0)};        ///< Color of empty cells and bars.
+  bool pyramid{true};                                   ///< Whether to halve tiles downscaled by a factor of 4 or more with pyrDown before the final INTER_AREA resize.
+  double label_scale{0.5};                              ///< Font scale of the tile labels.
+  ::cv::Scalar label_color{::cv::Scalar::all(255)};     ///< Color of the tile labels.
+  ::cv::Scalar label_background{::cv::Scalar::all(0)};  ///< Color of the box behind the tile labels.
+};
+
+/*! \cond INTERNAL */
+namespace detail {
+
+inline int channel_conversion(const int from, const int to) {
+  if(from == 1 && to == 3) {
+    return ::cv::COLOR_GRAY2BGR;
+  }
+  if(from == 1 && to == 4) {
+    return ::cv::COLOR_GRAY2BGRA;
+  }
+  if(from == 3 && to == 1) {
+    return ::cv::COLOR_BGR2GRAY;
+  }
+  if(from == 4 && to == 1) {
+    return ::cv::COLOR_BGRA2GRAY;
+  }
+  if(from == 3 && to == 4) {
+    return ::cv::COLOR_BGR2BGRA;
+  }
+  if(from == 4 && to == 3) {
+    return ::cv::COLOR_BGRA2BGR;
+  }
+  throw std::invalid_argument("Unsupported channel conversion in montage");
+}
+
+inline void bands(const ::cv::Rect &cell, const ::cv::Rect &inner, std::vector<::cv::Rect> &out) {
+  const ::cv::Rect candidates[] = {
+      {cell.x, cell.y, cell.width, inner.y - cell.y},
+      {cell.x, inner.y + inner.height, cell.width, cell.y + cell.height - inner.y - inner.height},
+      {cell.x, inner.y, inner.x - cell.x, inner.height},
+      {inner.x + inner.width, inner.y, cell.x + cell.width - inner.x - inner.width, inner.height}};
+  for(const ::cv::Rect &r : candidates) {
+    if(r.width > 0 && r.height > 0) {
+      out.push_back(r);
+    }
+  }
+}
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Builds montages from a matrix of images, caching the layout across frames.
  *
- * This function takes a vector of vectors of images and creates a montage by resizing and concatenating them.
+ * The reference tile size, the region of each tile in the canvas and the empty cells are computed once
+ * and reused while the size and type of every input stay the same, so steady-state frames only resize
+ * each image into its region of the canvas, spread over several threads. The input images are not modified.
  *
- * @param images Vector of vectors of images.
- * @return A single montage image.
+ * Each image is placed in its cell according to the configured layout: stretched, fitted or letterboxed
+ * preserving its aspect ratio, or cropped to fill the cell. Cells take the size of the smallest image
+ * unless a montage size is given, in which case the canvas is split evenly. The interpolation is chosen
+ * per tile (INTER_AREA when downscaling, INTER_LINEAR otherwise) unless one is configured. Tiles that are
+ * shrunk by a factor of 4 or more are first halved with pyrDown into per-tile buffers, so the final
+ * resize only covers a small ratio.
+ *
+ * Images whose type differs from the montage type are converted while they are written into the canvas,
+ * using per-tile buffers that are reused across frames: gray is expanded to color (and vice versa),
+ * 16-bit images are scaled to 8 bits and floating-point images are normalized to the 8-bit range.
+ * Channel counts without a conversion (e.g., 2-channel images) are rejected with std::invalid_argument
+ * when the layout is computed, before any tile is drawn.
+ *
+ * Tiles can be labeled (e.g., with the camera name and frame rate). Labels are assembled from a cache of
+ * glyphs rendered once with putText and kept as masks per tile, so a label that did not change since the
+ * previous frame is only blitted, and a changed one is rebuilt from cached glyphs.
+ *
+ * @example
+ * @code
+ * rush::cv::MontageBuilder builder;
+ * while(running) {
+ *   const cv::Mat &canvas = builder({{left, right}, {depth}}, {{"left", "right"}, {"depth"}});
+ * }
+ * @endcode
  */
-inline ::cv::Mat montage(std::vector<std::vector<::cv::Mat>> &images) {
-  ::cv::Mat montage;
-  ::cv::Size ref{images[0][0].size()};
-  std::size_t max_col = 0;
+class MontageBuilder {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param cfg Configuration of the montage.
+   */
+  explicit MontageBuilder(MontageConfiguration cfg = MontageConfiguration()) : config_{cfg} {}
+
+  /**
+   * @brief Create a montage into the canvas owned by the builder.
+   *
+   * @param images Vector of vectors of images.
+   * @return The montage image. It remains valid until the next call.
+   */
+  const ::cv::Mat &operator()(const std::vector<std::vector<::cv::Mat>> &images) {
+    operator()(images, canvas_);
+    return canvas_;
+  }
+
+  /**
+   * @brief Create a montage into a preallocated canvas.
+   *
+   * @param images Vector of vectors of images.
+   * @param canvas The output montage image. It is only reallocated if its size or type changes.
+   */
+  void operator()(const std::vector<std::vector<::cv::Mat>> &images, ::cv::Mat &canvas) {
+    build(images, nullptr, canvas);
+  }
+
+  /**
+   * @brief Create a labeled montage into the canvas owned by the builder.
+   *
+   * @param images Vector of vectors of images.
+   * @param labels Vector of vectors of labels, drawn at the top-left corner of the corresponding tiles. Missing or empty labels are not drawn.
+   * @return The montage image. It remains valid until the next call.
+   */
+  const ::cv::Mat &operator()(const std::vector<std::vector<::cv::Mat>> &images, const std::vector<std::vector<std::string>> &labels) {
+    operator()(images, labels, canvas_);
+    return canvas_;
+  }
+
+  /**
+   * @brief Create a labeled montage into a preallocated canvas.
+   *
+   * @param images Vector of vectors of images.
+   * @param labels Vector of vectors of labels, drawn at the top-left corner of the corresponding tiles. Missing or empty labels are not drawn.
+   * @param canvas The output montage image. It is only reallocated if its size or type changes.
+   */
+  void operator()(const std::vector<std::vector<::cv::Mat>> &images, const std::vector<std::vector<std::string>> &labels, ::cv::Mat &canvas) {
+    build(images, &labels, canvas);
+  }
 
-  for(const std::vector<::cv::Mat> &v : images) {
-    for(const ::cv::Mat &i : v) {
-      if(i.size().area() < ref.area()) {
-        ref = i.size();
+  /**
+   * @brief Force the layout to be recomputed on the next call.
+   */
+  void invalidate() {
+    tiles_.clear();
+    background_.clear();
+    type_ = -1;
+  }
+
+private:
+  struct Tile {
+    std::size_t row;
+    std::size_t col;
+    ::cv::Size size;
+    int type;
+    ::cv::Rect src;
+    ::cv::Rect roi;
+    int interpolation;
+    int conversion;
+    std::vector<::cv::Mat> pyramid;
+    ::cv::Mat resized;
+    ::cv::Mat converted;
+    std::string label;
+    ::cv::Mat text;
+  };
+
+  void build(const std::vector<std::vector<::cv::Mat>> &images, const std::vector<std::vector<std::string>> *labels, ::cv::Mat &canvas) {
+    if(outdated(images)) {
+      update(images);
+    }
+    for(Tile &t : tiles_) {
+      const std::string *label = (labels != nullptr && t.row < labels->size() && t.col < (*labels)[t.row].size()) ? &(*labels)[t.row][t.col] : nullptr;
+      if(label == nullptr || label->empty()) {
+        t.label.clear();
+        t.text.release();
+      } else if(*label != t.label) {
+        t.label = *label;
+        typeset(t.label, t.text);
+      }
+    }
+    canvas.create(size_, type_);
+    const auto render = [this, &images, &canvas](const ::cv::Range &range) {
+      for(int i = range.start; i < range.end; i++) {
+        Tile &t = tiles_[static_cast<std::size_t>(i)];
+        ::cv::Mat roi = canvas(t.roi);
+        draw(images[t.row][t.col], t, roi);
+        if(!t.text.empty()) {
+          const ::cv::Rect box(0, 0, std::min(t.text.cols, roi.cols), std::min(t.text.rows, roi.rows));
+          ::cv::Mat area = roi(box);
+          area.setTo(config_.label_background);
+          area.setTo(config_.label_color, t.text(box));
+        }
+      }
+    };
+    const ::cv::Range all(0, static_cast<int>(tiles_.size()));
+    if(config_.parallel && tiles_.size() > 1) {
+      ::cv::parallel_for_(all, render);
+    } else {
+      render(all);
+    }
+    for(const ::cv::Rect &r : background_) {
+      canvas(r).setTo(config_.background);
+    }
+  }
+
+  [[nodiscard]] bool outdated(const std::vector<std::vector<::cv::Mat>> &images) const {
+    std::size_t n = 0;
+    for(const std::vector<::cv::Mat> &v : images) {
+      n += v.size();
+    }
+    if(n != tiles_.size() || type_ < 0) {
+      return true;
+    }
+    return std::any_of(tiles_.begin(), tiles_.end(), [&images](const Tile &t) {
+      return t.row >= images.size() || t.col >= images[t.row].size() || images[t.row][t.col].size() != t.size || images[t.row][t.col].type() != t.type;
+    });
+  }
+
+  void update(const std::vector<std::vector<::cv::Mat>> &images) {
+    invalidate();
+    ::cv::Size ref{images[0][0].size()};
+    std::size_t max_col = 0;
+    bool mixed = false;
+    int channels = 1;
+    for(const std::vector<::cv::Mat> &v : images) {
+      for(const ::cv::Mat &i : v) {
+        if(i.size().area() < ref.area()) {
+          ref = i.size();
+        }
+        mixed |= i.type() != images[0][0].type();
+        channels = std::max(channels, i.channels());
       }
       max_col = std::max(max_col, v.size());
     }
+
+    const int cols = static_cast<int>(max_col);
+    const int rows = static_cast<int>(images.size());
+    if(config_.size.width > 0 && config_.size.height > 0) {
+      ref = ::cv::Size(config_.size.width / cols, config_.size.height / rows);
+      size_ = config_.size;
+      detail::bands(::cv::Rect(0, 0, size_.width, size_.height), ::cv::Rect(0, 0, cols * ref.width, rows * ref.height), background_);
+    } else {
+      size_ = ::cv::Size(cols * ref.width, rows * ref.height);
+    }
+    const int type = (config_.type >= 0) ? config_.type : (mixed ? CV_MAKETYPE(CV_8U, channels) : images[0][0].type());
+    for(const std::vector<::cv::Mat> &v : images) {
+      for(const ::cv::Mat &i : v) {
+        if(i.channels() != CV_MAT_CN(type)) {
+          detail::channel_conversion(i.channels(), CV_MAT_CN(type));
+        }
+      }
+    }
+    type_ = type;
+    for(std::size_t r = 0; r < images.size(); r++) {
+      for(std::size_t c = 0; c < max_col; c++) {
+        const ::cv::Rect cell(static_cast<int>(c) * ref.width, static_cast<int>(r) * ref.height, ref.width, ref.height);
+        if(c < images[r].size()) {
+          place(images[r][c], r, c, cell);
+        } else {
+          background_.push_back(cell);
+        }
+      }
+    }
   }
 
-  std::vector<::cv::Mat> rows;
-  for(std::vector<::cv::Mat> &v : images) {
-    for(::cv::Mat &i : v) {
-      ::cv::resize(i, i, ref);
+  void place(const ::cv::Mat &image, const std::size_t r, const std::size_t c, const ::cv::Rect &cell) {
+    const ::cv::Size in = image.size();
+    ::cv::Rect src(0, 0, in.width, in.height);
+    ::cv::Rect roi = cell;
+    const double sx = static_cast<double>(cell.width) / in.width;
+    const double sy = static_cast<double>(cell.height) / in.height;
+    if(config_.layout == MontageLayout::fit || config_.layout == MontageLayout::letterbox) {
+      const double scale = std::min(sx, sy);
+      roi.width = std::clamp(static_cast<int>(std::lround(in.width * scale)), 1, cell.width);
+      roi.height = std::clamp(static_cast<int>(std::lround(in.height * scale)), 1, cell.height);
+      if(config_.layout == MontageLayout::letterbox) {
+        roi.x += (cell.width - roi.width) / 2;
+        roi.y += (cell.height - roi.height) / 2;
+      }
+      detail::bands(cell, roi, background_);
+    } else if(config_.layout == MontageLayout::fill) {
+      const double scale = std::max(sx, sy);
+      src.width = std::clamp(static_cast<int>(std::lround(cell.width / scale)), 1, in.width);
+      src.height = std::clamp(static_cast<int>(std::lround(cell.height / scale)), 1, in.height);
+      src.x = (in.width - src.width) / 2;
+      src.y = (in.height - src.height) / 2;
     }
-    while(v.size() < max_col) {
-      v.emplace_back(ref, images[0][0].type(), ::cv::Scalar(0));
+
+    int interpolation = config_.interpolation;
+    if(interpolation < 0) {
+      interpolation = (roi.width < src.width && roi.height < src.height) ? ::cv::INTER_AREA : ::cv::INTER_LINEAR;
+    }
+    std::size_t levels = 0;
+    if(config_.pyramid && interpolation == ::cv::INTER_AREA && src.width >= 4 * roi.width && src.height >= 4 * roi.height) {
+      for(::cv::Size s = src.size(); s.width >= 2 * roi.width && s.height >= 2 * roi.height; levels++) {
+        s = ::cv::Size((s.width + 1) / 2, (s.height + 1) / 2);
+      }
     }
-    rows.emplace_back(v.size() * ref.width, ref.height, images[0][0].type());
-    ::cv::hconcat(v.data(), v.size(), rows.back());
+    tiles_.push_back({r, c, in, image.type(), src, roi, interpolation, image.channels() == CV_MAT_CN(type_) ? -1 : detail::channel_conversion(image.channels(), CV_MAT_CN(type_)), std::vector<::cv::Mat>(levels), {}, {}, {}, {}});
   }
-  ::cv::vconcat(rows.data(), rows.size(), montage);
-  return montage;
+
+  void draw(const ::cv::Mat &input, Tile &t, ::cv::Mat &roi) const {
+    ::cv::Mat image = input(t.src);
+    for(::cv::Mat &level : t.pyramid) {
+      ::cv::pyrDown(image, level);
+      image = level;
+    }
+    if(image.type() == type_) {
+      ::cv::resize(image, roi, roi.size(), 0, 0, t.interpolation);
+      return;
+    }
+
+    const int depth = CV_MAT_DEPTH(type_);
+    const int channels = CV_MAT_CN(type_);
+    ::cv::resize(image, t.resized, roi.size(), 0, 0, t.interpolation);
+    const ::cv::Mat *src = &t.resized;
+    if(image.depth() != depth) {
+      double alpha = 1;
+      double beta = 0;
+      if(image.depth() == CV_32F || image.depth() == CV_64F) {
+        double lo = 0;
+        double hi = 0;
+        ::cv::minMaxLoc(t.resized.reshape(1), &lo, &hi);
+        const double range = (depth == CV_32F || depth == CV_64F) ? 1.0 : (depth == CV_8U) ? 255.0 : (depth == CV_16U) ? 65535.0 : 1.0;
+        alpha = (hi > lo) ? range / (hi - lo) : 1;
+        beta = -lo * alpha;
+      } else if(image.depth() == CV_16U && depth == CV_8U) {
+        alpha = 1.0 / 256;
+      } else if(image.depth() == CV_8U && depth == CV_16U) {
+        alpha = 256;
+      }
+      ::cv::Mat &dst = (image.channels() == channels) ? roi : t.converted;
+      t.resized.convertTo(dst, depth, alpha, beta);
+      src = &t.converted;
+    }
+    if(image.channels() != channels) {
+      ::cv::cvtColor(*src, roi, t.conversion);
+    }
+  }
+
+  void typeset(const std::string &label, ::cv::Mat &text) {
+    static constexpr int font = ::cv::FONT_HERSHEY_SIMPLEX;
+    static constexpr int padding = 2;
+    int width = 0;
+    int height = 0;
+    for(const char ch : label) {
+      ::cv::Mat &glyph = glyphs_[ch];
+      if(glyph.empty()) {
+        int baseline = 0;
+        const ::cv::Size size = ::cv::getTextSize(std::string(1, ch), font, config_.label_scale, 1, &baseline);
+        glyph = ::cv::Mat(::cv::Size(std::max(size.width, 1), size.height + baseline), CV_8UC1, ::cv::Scalar(0));
+        ::cv::putText(glyph, std::string(1, ch), ::cv::Point(0, size.height), font, config_.label_scale, ::cv::Scalar(255), 1, ::cv::LINE_8);
+      }
+      width += glyph.cols;
+      height = std::max(height, glyph.rows);
+    }
+    text = ::cv::Mat(::cv::Size(width + 2 * padding, height + 2 * padding), CV_8UC1, ::cv::Scalar(0));
+    int x = padding;
+    for(const char ch : label) {
+      const ::cv::Mat &glyph = glyphs_[ch];
+      ::cv::Mat dst = text(::cv::Rect(x, padding, glyph.cols, glyph.rows));
+      glyph.copyTo(dst);
+      x += glyph.cols;
+    }
+  }
+
+  MontageConfiguration config_;
+  std::unordered_map<char, ::cv::Mat> glyphs_;
+  std::vector<Tile> tiles_;
+  std::vector<::cv::Rect> background_;
+  ::cv::Size size_;
+  int type_{-1};
+  ::cv::Mat canvas_;
+};
+
+/**
+ * @brief Create a montage from a matrix of images into a preallocated canvas.
+ *
+ * Every image is resized to the size of the smallest one and written directly into its region of the canvas,
+ * so no intermediate images are allocated. The canvas is only reallocated if its size or type changes,
+ * which allows reusing it across frames. The input images are not modified.
+ *
+ * @param images Vector of vectors of images.
+ * @param canvas The output montage image.
+ * @see MontageBuilder
+ */
+inline void montage(const std::vector<std::vector<::cv::Mat>> &images, ::cv::Mat &canvas) {
+  MontageBuilder()(images, canvas);
+}
+
+/**
+ * @brief Create a montage from a matrix of images.
+ *
+ * This function takes a vector of vectors of images and creates a montage by resizing and concatenating them.
+ *
+ * @param images Vector of vectors of images.
+ * @return A single montage image.
+ * @see montage(const std::vector<std::vector<::cv::Mat>> &images, ::cv::Mat &canvas)
+ */
+inline ::cv::Mat montage(const std::vector<std::vector<::cv::Mat>> &images) {
+  ::cv::Mat canvas;
+  montage(images, canvas);
+  return canvas;
 }
 
 /**
@@ -64,9 +460,9 @@ inline ::cv::Mat montage(std::vector<std::vector<::cv::Mat>> &images) {
  * @param images Vector of images.
  * @param step Step size for selecting images.
  * @return A single montage image.
- * @see montage(std::vector<std::vector<::cv::Mat>> &images)
+ * @see montage(const std::vector<std::vector<::cv::Mat>> &images)
  */
-inline ::cv::Mat montage(std::vector<::cv::Mat> &images, std::size_t step = 0) {
+inline ::cv::Mat montage(const std::vector<::cv::Mat> &images, std::size_t step = 0) {
   std::vector<std::vector<::cv::Mat>> img_vector;
   if(!static_cast<bool>(step)) {
     step = images.size();
@@ -77,6 +473,305 @@ inline ::cv::Mat montage(std::vector<::cv::Mat> &images, std::size_t step = 0) {
   return montage(img_vector);
 }
 
+/**
+ * @brief Records montages to a video file without blocking the caller on the encoder.
+ *
+ * Montages are built into a scratch canvas and swapped into a small ring of canvases that is shared with
+ * a writer thread, which encodes them with cv::VideoWriter. While the writer encodes one canvas, the caller
+ * builds the next one, and encoded canvases are swapped back for reuse. If every canvas is still waiting
+ * to be encoded, the new frame is dropped instead of stalling the caller.
+ *
+ * @tparam Depth Number of canvases (2 for double buffering).
+ *
+ * @example
+ * @code
+ * rush::cv::MontageRecorder<> recorder("debug.avi", cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 30);
+ * while(running) {
+ *   recorder.record({{left, right}, {depth}});
+ * }
+ * @endcode
+ */
+template <std::size_t Depth = 2>
+class MontageRecorder {
+public:
+  /**
+   * @brief Constructor. The video file is opened when the first montage is recorded.
+   *
+   * @param filename Name of the output video file.
+   * @param fourcc Codec used to compress the frames.
+   * @param fps Frame rate of the video.
+   * @param cfg Configuration of the montage.
+   */
+  MontageRecorder(std::string filename, const int fourcc, const double fps, MontageConfiguration cfg = MontageConfiguration()) : filename_{std::move(filename)}, fourcc_{fourcc}, fps_{fps}, builder_{cfg}, thread_{&MontageRecorder::run, this} {}
+
+  ~MontageRecorder() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  MontageRecorder(const MontageRecorder &) = delete;
+  MontageRecorder(MontageRecorder &&) noexcept = delete;
+  MontageRecorder &operator=(const MontageRecorder &) = delete;
+  MontageRecorder &operator=(MontageRecorder &&other) noexcept = delete;
+
+  /**
+   * @brief Build a montage and queue it for encoding.
+   *
+   * @param images Vector of vectors of images.
+   * @return True if the frame was queued, false if it was dropped because the writer is behind.
+   * @throws std::runtime_error If the video file cannot be opened.
+   */
+  bool record(const std::vector<std::vector<::cv::Mat>> &images) {
+    if(frames_.size() == Depth) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    builder_(images, scratch_);
+    if(!opened_) {
+      if(!writer_.open(filename_, fourcc_, fps_, scratch_.size(), scratch_.channels() > 1)) {
+        throw std::runtime_error("Could not open video file " + filename_);
+      }
+      opened_ = true;
+    }
+    frames_.produce([this](::cv::Mat &canvas) { ::cv::swap(canvas, scratch_); });
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Get the number of frames encoded so far.
+   *
+   * @return Number of frames written to the video file.
+   */
+  [[nodiscard]] std::size_t recorded() const {
+    return recorded_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the number of frames dropped so far.
+   *
+   * @return Number of frames discarded because every canvas was waiting to be encoded.
+   */
+  [[nodiscard]] std::size_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true) {
+      cv_.wait(lock, [this] { return stop_ || !frames_.empty(); });
+      lock.unlock();
+      while(frames_.consume([this](::cv::Mat &canvas) { writer_.write(canvas); })) {
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+      }
+      lock.lock();
+      if(stop_ && frames_.empty()) {
+        break;
+      }
+    }
+    writer_.release();
+  }
+
+  std::string filename_;
+  int fourcc_;
+  double fps_;
+  MontageBuilder builder_;
+  ::cv::Mat scratch_;
+  bool opened_{false};
+  ::cv::VideoWriter writer_;
+  RingBuffer<::cv::Mat, Depth> frames_;
+  std::atomic<std::size_t> recorded_{0};
+  std::atomic<std::size_t> dropped_{0};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+/**
+ * @brief Configuration structure for viewers.
+ */
+struct ViewerConfiguration {
+  double fps{30.0};                           ///< Maximum display rate. It must be positive.
+  bool montage{false};                        ///< Whether to compose all windows into a single montage window.
+  std::string name{"rush"};                   ///< Name of the montage window.
+  std::size_t columns{0};                     ///< Number of columns of the montage. If zero, the windows are arranged in a square grid.
+  MontageConfiguration layout{};              ///< Configuration of the montage.
+};
+
+/*! \cond INTERNAL */
+namespace detail {
+
+class LatestFrame {
+public:
+  void write(const ::cv::Mat &frame) {
+    frame.copyTo(buffers_[back_]);
+    back_ = state_.exchange(static_cast<std::uint8_t>(back_ | fresh), std::memory_order_acq_rel) & index;
+  }
+
+  bool read() {
+    if((state_.load(std::memory_order_relaxed) & fresh) == 0) {
+      return false;
+    }
+    front_ = state_.exchange(front_, std::memory_order_acq_rel) & index;
+    return true;
+  }
+
+  [[nodiscard]] const ::cv::Mat &front() const {
+    return buffers_[front_];
+  }
+
+private:
+  static constexpr std::uint8_t index = 3;
+  static constexpr std::uint8_t fresh = 4;
+  ::cv::Mat buffers_[3];
+  std::atomic<std::uint8_t> state_{1};
+  std::uint8_t back_{0};
+  std::uint8_t front_{2};
+};
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Displays images from any thread without blocking on HighGUI.
+ *
+ * All HighGUI calls (window creation, imshow and waitKey) run on a dedicated thread at a capped rate.
+ * Each window keeps only its latest frame in a lock-free triple buffer, so producers never wait for the
+ * display and frames that arrive faster than the display rate are silently replaced. Optionally, all
+ * windows are composed into a single montage window.
+ *
+ * @note Each window must be written by a single thread at a time.
+ *
+ * @example
+ * @code
+ * rush::cv::Viewer viewer;
+ * viewer.show("left", left);
+ * viewer.show("right", right);
+ * if(viewer.key() == 'q') {
+ *   running = false;
+ * }
+ * @endcode
+ */
+class Viewer {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param cfg Configuration of the viewer.
+   */
+  explicit Viewer(ViewerConfiguration cfg = ViewerConfiguration()) : config_{std::move(cfg)}, builder_{config_.layout}, thread_{&Viewer::run, this} {}
+
+  ~Viewer() {
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+  }
+
+  Viewer(const Viewer &) = delete;
+  Viewer(Viewer &&) noexcept = delete;
+  Viewer &operator=(const Viewer &) = delete;
+  Viewer &operator=(Viewer &&other) noexcept = delete;
+
+  /**
+   * @brief Queue an image for display, replacing any frame of the same window that was not shown yet.
+   *
+   * @param name Name of the window.
+   * @param image Image to be displayed. It is copied, so it can be reused right after the call.
+   */
+  void show(const std::string &name, const ::cv::Mat &image) {
+    window(name).write(image);
+  }
+
+  /**
+   * @brief Get the last key pressed in any window and clear it.
+   *
+   * @return Code of the key, or -1 if no key was pressed since the last call.
+   */
+  [[nodiscard]] int key() {
+    return key_.exchange(-1, std::memory_order_relaxed);
+  }
+
+private:
+  detail::LatestFrame &window(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<detail::LatestFrame> &w = windows_[name];
+    if(!w) {
+      w = std::make_unique<detail::LatestFrame>();
+      order_.emplace_back(name, w.get());
+    }
+    return *w;
+  }
+
+  void run() {
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / config_.fps));
+    auto next = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, detail::LatestFrame *>> windows;
+    std::vector<::cv::Mat> frames;
+    while(!stop_.load(std::memory_order_acquire)) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        windows.insert(windows.end(), order_.begin() + static_cast<long>(windows.size()), order_.end());
+      }
+      bool updated = false;
+      frames.clear();
+      for(const auto &[name, w] : windows) {
+        const bool fresh = w->read();
+        updated |= fresh;
+        if(config_.montage) {
+          if(!w->front().empty()) {
+            frames.push_back(w->front());
+          }
+        } else if(fresh) {
+          ::cv::imshow(name, w->front());
+        }
+      }
+      if(config_.montage && updated && !frames.empty()) {
+        compose(frames);
+      }
+      if(const int k = ::cv::waitKey(1); k != -1) {
+        key_.store(k, std::memory_order_relaxed);
+      }
+      next += period;
+      const auto now = std::chrono::steady_clock::now();
+      if(next < now) {
+        next = now;
+      }
+      std::this_thread::sleep_until(next);
+    }
+    ::cv::destroyAllWindows();
+  }
+
+  void compose(const std::vector<::cv::Mat> &frames) {
+    std::size_t columns = config_.columns;
+    if(columns == 0) {
+      columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(frames.size()))));
+    }
+    grid_.resize((frames.size() + columns - 1) / columns);
+    for(std::size_t r = 0; r < grid_.size(); r++) {
+      grid_[r].assign(frames.begin() + static_cast<long>(r * columns), frames.begin() + static_cast<long>(std::min(frames.size(), (r + 1) * columns)));
+    }
+    ::cv::imshow(config_.name, builder_(grid_));
+  }
+
+  ViewerConfiguration config_;
+  MontageBuilder builder_;
+  std::vector<std::vector<::cv::Mat>> grid_;
+  std::unordered_map<std::string, std::unique_ptr<detail::LatestFrame>> windows_;
+  std::vector<std::pair<std::string, detail::LatestFrame *>> order_;
+  std::mutex mutex_;
+  std::atomic<int> key_{-1};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
 } // namespace rush::cv
 
 #endif // RUSH_CV_HIGHGUI_HPP
@@ -0,0 +1,166 @@
+/**
+ * @file parallel-algorithm.hpp
+ * @brief This library provides parallel versions of rush algorithms on top of the thread pool.
+ * @author Raul Tapia (raultapia.com)
+ * @copyright GNU General Public License v3.0
+ * @see https://github.com/raultapia/rush
+ */
+#ifndef RUSH_PARALLEL_ALGORITHM_HPP
+#define RUSH_PARALLEL_ALGORITHM_HPP
+
+#include "rush/algorithm.hpp"
+#include "rush/thread-pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace rush {
+
+/**
+ * @brief Execution policies for the algorithms in this library.
+ */
+namespace execution {
+
+/**
+ * @brief Policy requesting that an algorithm runs on several threads.
+ */
+struct parallel_policy {};
+
+inline constexpr parallel_policy par{}; ///< Convenience instance of parallel_policy.
+
+} // namespace execution
+
+/**
+ * @brief Clamps an array of values within the inclusive range [lo, hi] using several threads.
+ *
+ * The array is split into contiguous chunks processed by the SIMD kernel on the shared ThreadPool.
+ * Small arrays are processed on the calling thread.
+ *
+ * @tparam T The type of the values and the bounds.
+ * @param policy The parallel execution policy.
+ * @param in Pointer to the input values.
+ * @param out Pointer to the output values.
+ * @param n The number of values.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ */
+template <class T>
+void clamp([[maybe_unused]] const execution::parallel_policy &policy, const T *in, T *out, const std::size_t n, const detail::type_identity_t<T> lo, const detail::type_identity_t<T> hi) {
+  const std::size_t chunk = std::max<std::size_t>(1 << 16, ThreadPool::global().chunk_size(n));
+  ThreadPool::global().parallel_for(0, n, chunk, [&](const std::size_t begin, const std::size_t end) { detail::clamp_kernel<true, true>(in + begin, out + begin, end - begin, lo, hi); });
+}
+
+#if __cplusplus >= 202002L
+/**
+ * @brief Clamps a span of values within the inclusive range [lo, hi] using several threads.
+ *
+ * @tparam T The type of the values and the bounds.
+ * @param policy The parallel execution policy.
+ * @param in The input values.
+ * @param out The output values. It must have at least as many elements as the input.
+ * @param lo The lower bound of the range.
+ * @param hi The upper bound of the range.
+ */
+template <class T>
+void clamp(const execution::parallel_policy &policy, std::span<const std::type_identity_t<T>> in, std::span<T> out, const std::type_identity_t<T> lo, const std::type_identity_t<T> hi) {
+  clamp(policy, in.data(), out.data(), in.size(), lo, hi);
+}
+#endif
+
+/**
+ * @brief Calls a function for every index in a range, using several threads.
+ *
+ * The range is split into chunks that are distributed over the shared ThreadPool.
+ *
+ * @tparam F The type of the function.
+ * @param begin The first index.
+ * @param end The index past the last one.
+ * @param f Callable invoked as `f(i)` for every index. It must not throw.
+ * @param chunk The number of indices per chunk. If zero, it is chosen automatically.
+ *
+ * @example
+ * @code
+ * rush::parallel_for(0, image.rows, [&](std::size_t r) { process(image.row(r)); });
+ * @endcode
+ */
+template <class F>
+void parallel_for(const std::size_t begin, const std::size_t end, F &&f, const std::size_t chunk = 0) {
+  ThreadPool::global().parallel_for(begin, end, chunk, [&f](const std::size_t b, const std::size_t e) {
+    for(std::size_t i = b; i < e; i++) {
+      f(i);
+    }
+  });
+}
+
+/**
+ * @brief Stores the result of a function for every index in a range, using several threads.
+ *
+ * @tparam T The type of the output values.
+ * @tparam F The type of the function.
+ * @param begin The first index.
+ * @param end The index past the last one.
+ * @param out Pointer to the output values, where `out[i] = f(i)` is stored.
+ * @param f Callable invoked as `f(i)` for every index. It must not throw.
+ * @param chunk The number of indices per chunk. If zero, it is chosen automatically.
+ * @see parallel_for(const std::size_t begin, const std::size_t end, F &&f, const std::size_t chunk)
+ */
+template <class T, class F>
+void parallel_transform(const std::size_t begin, const std::size_t end, T *out, F &&f, const std::size_t chunk = 0) {
+  ThreadPool::global().parallel_for(begin, end, chunk, [out, &f](const std::size_t b, const std::size_t e) {
+    for(std::size_t i = b; i < e; i++) {
+      out[i] = f(i);
+    }
+  });
+}
+
+/**
+ * @brief Reduces the results of a function for every index in a range, using several threads.
+ *
+ * Each chunk is reduced on its own and the partial results are then combined in index order,
+ * so the result does not depend on the number of threads for a given chunk size.
+ *
+ * @tparam T The type of the result.
+ * @tparam F The type of the function.
+ * @tparam R The type of the reduction operation.
+ * @param begin The first index.
+ * @param end The index past the last one.
+ * @param init The initial value of the reduction.
+ * @param f Callable invoked as `f(i)` for every index. It must not throw.
+ * @param reduce Associative binary operation used to combine results.
+ * @param chunk The number of indices per chunk. If zero, it is chosen automatically.
+ * @return The reduction of init and all the results.
+ *
+ * @example
+ * @code
+ * double sum = rush::parallel_reduce(0, points.size(), 0.0, [&](std::size_t i) { return points[i].z; });
+ * @endcode
+ */
+template <class T, class F, class R = std::plus<>>
+T parallel_reduce(const std::size_t begin, const std::size_t end, T init, F &&f, R &&reduce = R(), std::size_t chunk = 0) {
+  if(begin >= end) {
+    return init;
+  }
+  ThreadPool &pool = ThreadPool::global();
+  chunk = (chunk > 0) ? chunk : pool.chunk_size(end - begin);
+  std::vector<T> partial((end - begin + chunk - 1) / chunk, init);
+  pool.parallel_for(begin, end, chunk, [&](const std::size_t b, const std::size_t e) {
+    T acc = f(b);
+    for(std::size_t i = b + 1; i < e; i++) {
+      acc = reduce(std::move(acc), f(i));
+    }
+    partial[(b - begin) / chunk] = std::move(acc);
+  });
+  for(T &p : partial) {
+    init = reduce(std::move(init), std::move(p));
+  }
+  return init;
+}
+
+} // namespace rush
+
+#endif // RUSH_PARALLEL_ALGORITHM_HPP
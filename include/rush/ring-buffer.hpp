@@ -0,0 +1,413 @@
+/**
+ * @file ring-buffer.hpp
+ * @brief This library provides lock-free bounded ring buffers.
+ * @author Raul Tapia (raultapia.com)
+ * @copyright GNU General Public License v3.0
+ * @see https://github.com/raultapia/rush
+ */
+#ifndef RUSH_RING_BUFFER_HPP
+#define RUSH_RING_BUFFER_HPP
+
+#include "rush/counter.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace rush {
+
+/**
+ * @brief Concurrency mode of a ring buffer.
+ */
+enum class RingBufferMode : std::uint8_t {
+  spsc, ///< Single producer, single consumer.
+  mpmc  ///< Multiple producers, multiple consumers.
+};
+
+/*! \cond INTERNAL */
+namespace detail {
+
+template <std::size_t N>
+constexpr std::size_t slot_index(const std::size_t pos) {
+  if constexpr((N & (N - 1)) == 0) {
+    return pos & (N - 1);
+  } else {
+    return pos % N;
+  }
+}
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief A lock-free bounded ring buffer for a single producer thread and a single consumer thread.
+ *
+ * Slots are default-constructed once and reused, so `produce` and `consume` give in-place access
+ * to the stored objects (e.g., a frame can be written into a slot that already owns a buffer).
+ * Producer and consumer state live on separate cache lines, and slots are indexed from the
+ * published positions, so a callback that throws leaves the buffer unchanged.
+ *
+ * @tparam T The type of the elements. It must be default-constructible.
+ * @tparam N The capacity of the buffer.
+ * @tparam Mode The concurrency mode.
+ *
+ * @example
+ * @code
+ * rush::RingBuffer<cv::Mat, 8> frames;
+ * // Producer thread:
+ * frames.produce([&](cv::Mat &slot) { camera.read(slot); });
+ * // Consumer thread:
+ * frames.consume([&](cv::Mat &slot) { process(slot); });
+ * @endcode
+ */
+template <typename T, std::size_t N, RingBufferMode Mode = RingBufferMode::spsc>
+class RingBuffer {
+  static_assert(N > 0, "Capacity must be greater than zero");
+
+public:
+  RingBuffer() = default;
+  ~RingBuffer() = default;
+  RingBuffer(const RingBuffer &) = delete;
+  RingBuffer(RingBuffer &&) noexcept = delete;
+  RingBuffer &operator=(const RingBuffer &) = delete;
+  RingBuffer &operator=(RingBuffer &&other) noexcept = delete;
+
+  /**
+   * @brief Write the next free slot in place.
+   *
+   * @param f Callable invoked as `f(T &slot)`. It must only be called from the producer thread.
+   * @return True if a slot was written, false if the buffer is full.
+   */
+  template <typename F>
+  bool produce(F &&f) {
+    const std::size_t tail = producer_.tail.load(std::memory_order_relaxed);
+    if(available(tail) == 0) {
+      return false;
+    }
+    std::forward<F>(f)(slots_[detail::slot_index<N>(tail)]);
+    producer_.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Read the oldest slot in place and release it.
+   *
+   * @param f Callable invoked as `f(T &slot)`. It must only be called from the consumer thread.
+   * @return True if a slot was read, false if the buffer is empty.
+   */
+  template <typename F>
+  bool consume(F &&f) {
+    const std::size_t head = consumer_.head.load(std::memory_order_relaxed);
+    if(pending(head) == 0) {
+      return false;
+    }
+    std::forward<F>(f)(slots_[detail::slot_index<N>(head)]);
+    consumer_.head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Copy an element into the buffer.
+   *
+   * @param x The element to push.
+   * @return True if the element was pushed, false if the buffer is full.
+   */
+  bool push(const T &x) {
+    return produce([&x](T &slot) { slot = x; });
+  }
+
+  /**
+   * @brief Move an element into the buffer.
+   *
+   * @param x The element to push.
+   * @return True if the element was pushed, false if the buffer is full.
+   */
+  bool push(T &&x) {
+    return produce([&x](T &slot) { slot = std::move(x); });
+  }
+
+  /**
+   * @brief Move the oldest element out of the buffer.
+   *
+   * @param x The variable where the element is stored.
+   * @return True if an element was popped, false if the buffer is empty.
+   */
+  bool pop(T &x) {
+    return consume([&x](T &slot) { x = std::move(slot); });
+  }
+
+  /**
+   * @brief Copy several elements into the buffer, publishing them at once.
+   *
+   * @param first Pointer to the first element.
+   * @param n The number of elements.
+   * @return The number of elements pushed, which is less than n if the buffer fills up.
+   */
+  std::size_t push(const T *first, const std::size_t n) {
+    const std::size_t tail = producer_.tail.load(std::memory_order_relaxed);
+    const std::size_t m = std::min(n, available(tail, n));
+    for(std::size_t i = 0; i < m; i++) {
+      slots_[detail::slot_index<N>(tail + i)] = first[i];
+    }
+    producer_.tail.store(tail + m, std::memory_order_release);
+    return m;
+  }
+
+  /**
+   * @brief Move several elements out of the buffer, releasing their slots at once.
+   *
+   * @param out Pointer to the output elements.
+   * @param n The maximum number of elements.
+   * @return The number of elements popped.
+   */
+  std::size_t pop(T *out, const std::size_t n) {
+    const std::size_t head = consumer_.head.load(std::memory_order_relaxed);
+    const std::size_t m = std::min(n, pending(head, n));
+    for(std::size_t i = 0; i < m; i++) {
+      out[i] = std::move(slots_[detail::slot_index<N>(head + i)]);
+    }
+    consumer_.head.store(head + m, std::memory_order_release);
+    return m;
+  }
+
+  /**
+   * @brief Get the number of elements in the buffer.
+   *
+   * @return The number of elements. It may be outdated if other threads are operating on the buffer.
+   */
+  [[nodiscard]] std::size_t size() const {
+    const std::size_t head = consumer_.head.load(std::memory_order_acquire);
+    return producer_.tail.load(std::memory_order_acquire) - head;
+  }
+
+  /**
+   * @brief Check whether the buffer is empty.
+   *
+   * @return True if the buffer is empty.
+   */
+  [[nodiscard]] bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Get the capacity of the buffer.
+   *
+   * @return The maximum number of elements.
+   */
+  [[nodiscard]] static constexpr std::size_t capacity() {
+    return N;
+  }
+
+private:
+  std::size_t available(const std::size_t tail, const std::size_t wanted = 1) {
+    if(N - (tail - producer_.head) < wanted) {
+      producer_.head = consumer_.head.load(std::memory_order_acquire);
+    }
+    return N - (tail - producer_.head);
+  }
+
+  std::size_t pending(const std::size_t head, const std::size_t wanted = 1) {
+    if(consumer_.tail - head < wanted) {
+      consumer_.tail = producer_.tail.load(std::memory_order_acquire);
+    }
+    return consumer_.tail - head;
+  }
+
+  struct alignas(cache_line_size) Producer {
+    std::atomic<std::size_t> tail{0};
+    std::size_t head{0};
+  };
+
+  struct alignas(cache_line_size) Consumer {
+    std::atomic<std::size_t> head{0};
+    std::size_t tail{0};
+  };
+
+  Producer producer_;
+  Consumer consumer_;
+  std::array<T, N> slots_{};
+};
+
+/**
+ * @brief A lock-free bounded ring buffer for multiple producer threads and multiple consumer threads.
+ *
+ * Each slot carries a sequence number, so producers and consumers claim slots with a single
+ * compare-and-swap on their own cache-line-separated position. Slots are default-constructed once
+ * and reused, so `produce` and `consume` give in-place access to the stored objects.
+ *
+ * @tparam T The type of the elements. It must be default-constructible.
+ * @tparam N The capacity of the buffer.
+ */
+template <typename T, std::size_t N>
+class RingBuffer<T, N, RingBufferMode::mpmc> {
+  static_assert(N > 0, "Capacity must be greater than zero");
+
+public:
+  RingBuffer() {
+    for(std::size_t i = 0; i < N; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  ~RingBuffer() = default;
+  RingBuffer(const RingBuffer &) = delete;
+  RingBuffer(RingBuffer &&) noexcept = delete;
+  RingBuffer &operator=(const RingBuffer &) = delete;
+  RingBuffer &operator=(RingBuffer &&other) noexcept = delete;
+
+  /**
+   * @brief Write the next free slot in place.
+   *
+   * @param f Callable invoked as `f(T &slot)`. It must not throw, since the slot is claimed before it runs.
+   * @return True if a slot was written, false if the buffer is full.
+   */
+  template <typename F>
+  bool produce(F &&f) {
+    std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+    Slot *slot = claim(enqueue_, pos, 0);
+    if(slot == nullptr) {
+      return false;
+    }
+    std::forward<F>(f)(slot->value);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Read the oldest slot in place and release it.
+   *
+   * @param f Callable invoked as `f(T &slot)`. It must not throw, since the slot is claimed before it runs.
+   * @return True if a slot was read, false if the buffer is empty.
+   */
+  template <typename F>
+  bool consume(F &&f) {
+    std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+    Slot *slot = claim(dequeue_, pos, 1);
+    if(slot == nullptr) {
+      return false;
+    }
+    std::forward<F>(f)(slot->value);
+    slot->sequence.store(pos + N, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Copy an element into the buffer.
+   *
+   * @param x The element to push.
+   * @return True if the element was pushed, false if the buffer is full.
+   */
+  bool push(const T &x) {
+    return produce([&x](T &slot) { slot = x; });
+  }
+
+  /**
+   * @brief Move an element into the buffer.
+   *
+   * @param x The element to push.
+   * @return True if the element was pushed, false if the buffer is full.
+   */
+  bool push(T &&x) {
+    return produce([&x](T &slot) { slot = std::move(x); });
+  }
+
+  /**
+   * @brief Move the oldest element out of the buffer.
+   *
+   * @param x The variable where the element is stored.
+   * @return True if an element was popped, false if the buffer is empty.
+   */
+  bool pop(T &x) {
+    return consume([&x](T &slot) { x = std::move(slot); });
+  }
+
+  /**
+   * @brief Copy several elements into the buffer.
+   *
+   * @param first Pointer to the first element.
+   * @param n The number of elements.
+   * @return The number of elements pushed, which is less than n if the buffer fills up.
+   */
+  std::size_t push(const T *first, const std::size_t n) {
+    std::size_t i = 0;
+    while(i < n && push(first[i])) {
+      i++;
+    }
+    return i;
+  }
+
+  /**
+   * @brief Move several elements out of the buffer.
+   *
+   * @param out Pointer to the output elements.
+   * @param n The maximum number of elements.
+   * @return The number of elements popped.
+   */
+  std::size_t pop(T *out, const std::size_t n) {
+    std::size_t i = 0;
+    while(i < n && pop(out[i])) {
+      i++;
+    }
+    return i;
+  }
+
+  /**
+   * @brief Get the number of elements in the buffer.
+   *
+   * @return The number of elements. It may be outdated if other threads are operating on the buffer.
+   */
+  [[nodiscard]] std::size_t size() const {
+    const std::size_t head = dequeue_.load(std::memory_order_acquire);
+    const std::size_t tail = enqueue_.load(std::memory_order_acquire);
+    return (tail > head) ? std::min(tail - head, N) : 0;
+  }
+
+  /**
+   * @brief Check whether the buffer is empty.
+   *
+   * @return True if the buffer is empty.
+   */
+  [[nodiscard]] bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Get the capacity of the buffer.
+   *
+   * @return The maximum number of elements.
+   */
+  [[nodiscard]] static constexpr std::size_t capacity() {
+    return N;
+  }
+
+private:
+  struct Slot {
+    std::atomic<std::size_t> sequence{0};
+    T value{};
+  };
+
+  Slot *claim(std::atomic<std::size_t> &position, std::size_t &pos, const std::size_t lag) {
+    for(;;) {
+      Slot &slot = slots_[detail::slot_index<N>(pos)];
+      const auto diff = static_cast<std::ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) - (pos + lag));
+      if(diff == 0) {
+        if(position.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return &slot;
+        }
+      } else if(diff < 0) {
+        return nullptr;
+      } else {
+        pos = position.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  alignas(cache_line_size) std::atomic<std::size_t> enqueue_{0};
+  alignas(cache_line_size) std::atomic<std::size_t> dequeue_{0};
+  alignas(cache_line_size) std::array<Slot, N> slots_;
+};
+
+} // namespace rush
+
+#endif // RUSH_RING_BUFFER_HPP
@@ -8,16 +8,33 @@
 #ifndef RUSH_ROS_CV_BRIDGE_HPP
 #define RUSH_ROS_CV_BRIDGE_HPP
 
+#include "rush/ring-buffer.hpp"
+#include "rush/thread-pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <boost/make_shared.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <cv_bridge/cv_bridge.h>
+#include <memory>
+#include <mutex>
 #include <opencv2/core/hal/interface.h>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/mat.inl.hpp>
+#include <opencv2/imgcodecs.hpp>
 #include <ros/publisher.h>
 #include <ros/time.h>
+#include <sensor_msgs/CompressedImage.h>
 #include <sensor_msgs/Image.h>
 #include <sensor_msgs/image_encodings.h>
 #include <std_msgs/Header.h>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace rush::roscv {
 
@@ -26,7 +43,11 @@ public:
   Encoding() = delete;
 
   static inline std::string get(const cv::Mat &mat, const bool invert = true) {
-    switch(mat.type()) {
+    return get(mat.type(), invert);
+  }
+
+  static inline std::string get(const int type, const bool invert = true) {
+    switch(type) {
     case CV_8UC1:
       return sensor_msgs::image_encodings::MONO8;
     case CV_8UC3:
@@ -45,14 +66,33 @@ public:
   }
 };
 
+/*! \cond INTERNAL */
+namespace detail {
+
+inline cv::Mat allocate(sensor_msgs::Image &ros, const int rows, const int cols, const int type) {
+  ros.height = static_cast<std::uint32_t>(rows);
+  ros.width = static_cast<std::uint32_t>(cols);
+  ros.encoding = Encoding::get(type);
+  ros.is_bigendian = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+  ros.step = static_cast<std::uint32_t>(cols * CV_ELEM_SIZE(type));
+  ros.data.resize(static_cast<std::size_t>(ros.step) * ros.height);
+  return cv::Mat(rows, cols, type, ros.data.data(), ros.step);
+}
+
+} // namespace detail
+/*! \endcond */
+
 /**
  * @brief Converts an OpenCV Mat to a ROS Image message.
  * @param cv The input OpenCV Mat.
- * @param ros The output ROS Image message.
+ * @param ros The output ROS Image message. Its data buffer is reused if it is large enough.
  * @param header The header for the ROS Image message.
+ * @note The pixels are copied once, directly into the message data.
  */
 inline void cv2ros(const cv::Mat &cv, sensor_msgs::Image &ros, const std_msgs::Header &header = std_msgs::Header()) {
-  cv_bridge::CvImage(header, Encoding::get(cv), cv).toImageMsg(ros);
+  ros.header = header;
+  cv::Mat dst = detail::allocate(ros, cv.rows, cv.cols, cv.type());
+  cv.copyTo(dst);
 }
 
 /**
@@ -62,24 +102,155 @@ inline void cv2ros(const cv::Mat &cv, sensor_msgs::Image &ros, const std_msgs::H
  * @return The output ROS Image message.
  */
 inline sensor_msgs::ImagePtr cv2ros(const cv::Mat &cv, const std_msgs::Header &header = std_msgs::Header()) {
-  return cv_bridge::CvImage(header, Encoding::get(cv), cv).toImageMsg();
+  sensor_msgs::ImagePtr ros = boost::make_shared<sensor_msgs::Image>();
+  cv2ros(cv, *ros, header);
+  return ros;
+}
+
+/**
+ * @brief A ROS Image message together with an OpenCV Mat that writes directly into its data.
+ */
+struct LoanedImage {
+  sensor_msgs::ImagePtr msg; ///< The ROS Image message that owns the pixels.
+  cv::Mat mat;               ///< OpenCV view of the message data. It is valid while the message is alive.
+};
+
+/*! \cond INTERNAL */
+namespace detail {
+
+inline LoanedImage lend(sensor_msgs::ImagePtr msg, const cv::Size &size, const int type, const std_msgs::Header &header) {
+  if(Encoding::get(type).empty()) {
+    throw std::invalid_argument("Unsupported image type");
+  }
+  LoanedImage img{std::move(msg), cv::Mat()};
+  img.msg->header = header;
+  img.mat = allocate(*img.msg, size.height, size.width, type);
+  return img;
 }
 
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief Allocates a ROS Image message and exposes its data as an OpenCV Mat.
+ *
+ * Drawing or computing into the Mat fills the message in place, so it can be published without any copy
+ * (with nodelets, the message is even handed to subscribers in the same process without serialization).
+ *
+ * @param size The size of the image.
+ * @param type The OpenCV type of the image (e.g., CV_8UC3).
+ * @param header The header for the ROS Image message.
+ * @return The loaned image.
+ * @throws std::invalid_argument If the type has no ROS encoding.
+ */
+inline LoanedImage loan(const cv::Size &size, const int type, const std_msgs::Header &header = std_msgs::Header()) {
+  return detail::lend(boost::make_shared<sensor_msgs::Image>(), size, type, header);
+}
+
+/**
+ * @brief A pool of ROS messages whose data buffers are reused across frames.
+ *
+ * A message is handed out again once nobody else holds it (i.e., its use count dropped back to 1),
+ * so publishing images of the same size does not allocate after the first frames.
+ * This class is thread-safe.
+ *
+ * @tparam M The message type (e.g., sensor_msgs::Image).
+ */
+template <typename M>
+class MessagePool {
+public:
+  /**
+   * @brief Constructor.
+   * @param capacity Maximum number of messages kept in the pool.
+   */
+  explicit MessagePool(const std::size_t capacity = 4) : capacity_{capacity} {}
+
+  /**
+   * @brief Gets a message that is not in use, or allocates a new one if there is none.
+   * @return The message. Its previous contents are kept, so its data buffer can be reused.
+   */
+  [[nodiscard]] boost::shared_ptr<M> acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(const boost::shared_ptr<M> &msg : pool_) {
+      if(msg.use_count() == 1) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return msg;
+      }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    boost::shared_ptr<M> msg = boost::make_shared<M>();
+    if(pool_.size() < capacity_) {
+      pool_.push_back(msg);
+    }
+    return msg;
+  }
+
+  /**
+   * @brief Sets the maximum number of messages kept in the pool.
+   * @param capacity The new capacity. Zero disables pooling. Pooled messages beyond it are released.
+   */
+  void set_capacity(const std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    if(pool_.size() > capacity_) {
+      pool_.resize(capacity_);
+    }
+  }
+
+  /**
+   * @brief Gets the maximum number of messages kept in the pool.
+   * @return The capacity.
+   */
+  [[nodiscard]] std::size_t capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  /**
+   * @brief Gets the number of requests served with a pooled message.
+   * @return The number of hits.
+   */
+  [[nodiscard]] std::size_t hits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Gets the number of requests that needed a new message.
+   * @return The number of misses.
+   */
+  [[nodiscard]] std::size_t misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::vector<boost::shared_ptr<M>> pool_;
+  std::size_t capacity_;
+  std::atomic<std::size_t> hits_{0};
+  std::atomic<std::size_t> misses_{0};
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief A pool of ROS Image messages.
+ */
+using ImagePool = MessagePool<sensor_msgs::Image>;
+
 /**
  * @brief Converts a ROS Image message to an OpenCV Mat.
  * @param ros The input ROS Image message.
- * @param cv The output OpenCV Mat.
+ * @param cv The output OpenCV Mat. Its buffer is reused if it already has the right size and type.
+ * @note The message data is copied exactly once, directly into the output Mat.
  */
 inline void ros2cv(const sensor_msgs::Image &ros, cv::Mat &cv) {
-  (cv_bridge::toCvCopy(ros, ros.encoding)->image).copyTo(cv);
+  cv_bridge::toCvShare(ros, nullptr)->image.copyTo(cv);
 }
 
 /**
  * @brief Converts a ROS Image message to an OpenCV Mat.
  * @param ros The input ROS Image message.
- * @return The output OpenCV Mat.
+ * @return The output OpenCV Mat, which owns a copy of the message data.
  */
-inline cv::Mat &ros2cv(const sensor_msgs::Image &ros) {
+inline cv::Mat ros2cv(const sensor_msgs::Image &ros) {
   return cv_bridge::toCvCopy(ros, ros.encoding)->image;
 }
 
@@ -99,12 +270,141 @@ inline void ros2cv(const sensor_msgs::ImageConstPtr &ros, cv::Mat &cv) {
  * @return The output OpenCV Mat.
  * @note This function is provided for convenience when working with ImageConstPtr.
  */
-inline cv::Mat &ros2cv(const sensor_msgs::ImageConstPtr &ros) {
+inline cv::Mat ros2cv(const sensor_msgs::ImageConstPtr &ros) {
   return ros2cv(*ros);
 }
 
+/**
+ * @brief A ROS Image message together with an OpenCV Mat that reads its data.
+ */
+struct SharedImage {
+  sensor_msgs::ImageConstPtr msg; ///< The ROS Image message, kept alive as long as this object.
+  cv::Mat mat;                    ///< OpenCV view of the message data (or a converted copy). It must not be modified.
+};
+
+/**
+ * @brief Wraps a ROS Image message in an OpenCV Mat without copying its data.
+ *
+ * The result holds a reference to the message, so the Mat stays valid as long as the result is kept,
+ * even if the caller drops its own pointer (e.g., pooled messages are not reused while it is alive).
+ *
+ * @param ros The input ROS Image message.
+ * @param encoding The desired encoding. If empty or equal to the message encoding, the Mat aliases the message data; otherwise the image is converted into a new buffer.
+ * @return The shared image.
+ */
+inline SharedImage ros2cv_share(const sensor_msgs::ImageConstPtr &ros, const std::string &encoding = "") {
+  return {ros, cv_bridge::toCvShare(ros, encoding)->image};
+}
+
+/**
+ * @brief Enumeration for what an asynchronous publisher does with frames that cannot be published in time.
+ */
+enum class PublishPolicy : std::uint8_t {
+  drop_oldest, ///< When the queue is full, discard the oldest pending frame.
+  keep_latest  ///< Discard every pending frame, so only the most recent one is published.
+};
+
+/*! \cond INTERNAL */
+namespace detail {
+
+class PublishQueue {
+public:
+  static constexpr std::size_t capacity = 8;
+
+  PublishQueue(const ros::Publisher &publisher, std::shared_ptr<ImagePool> pool, const PublishPolicy policy) : publisher_{publisher}, pool_{std::move(pool)}, policy_{policy}, thread_{&PublishQueue::run, this} {}
+
+  ~PublishQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  PublishQueue(const PublishQueue &) = delete;
+  PublishQueue(PublishQueue &&) noexcept = delete;
+  PublishQueue &operator=(const PublishQueue &) = delete;
+  PublishQueue &operator=(PublishQueue &&other) noexcept = delete;
+
+  void push(cv::Mat img, std_msgs::Header header) {
+    Frame frame{std::move(img), std::move(header)};
+    Frame old;
+    if(policy_ == PublishPolicy::keep_latest) {
+      while(frames_.pop(old)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    while(!frames_.push(std::move(frame))) {
+      if(frames_.pop(old)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cv_.notify_one();
+  }
+
+  [[nodiscard]] PublishPolicy policy() const {
+    return policy_;
+  }
+
+  [[nodiscard]] std::size_t depth() const {
+    return frames_.size();
+  }
+
+  [[nodiscard]] std::size_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Frame {
+    cv::Mat image;
+    std_msgs::Header header;
+  };
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Frame frame;
+    while(true) {
+      cv_.wait(lock, [this] { return stop_ || !frames_.empty(); });
+      lock.unlock();
+      while(frames_.pop(frame)) {
+        const sensor_msgs::ImagePtr msg = pool_->acquire();
+        cv2ros(frame.image, *msg, frame.header);
+        frame.image.release();
+        publisher_.publish(sensor_msgs::ImageConstPtr(msg));
+      }
+      lock.lock();
+      if(stop_ && frames_.empty()) {
+        break;
+      }
+    }
+  }
+
+  ros::Publisher publisher_;
+  std::shared_ptr<ImagePool> pool_;
+  PublishPolicy policy_;
+  RingBuffer<Frame, capacity, RingBufferMode::mpmc> frames_;
+  std::atomic<std::size_t> dropped_{0};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+} // namespace detail
+/*! \endcond */
+
 /**
  * @brief This class extends ros::Publisher to directly publish OpenCV matrices.
+ *
+ * Messages are taken from an ImagePool, so their data buffers are reused once subscribers release them.
+ * Copies of a publisher share the same pool.
+ *
+ * In asynchronous mode, publishing an OpenCV Mat only enqueues it in a bounded lock-free queue, and a
+ * dedicated thread converts and publishes it, so serialization and transport never block the caller.
  */
 class Publisher : public ros::Publisher {
   using ros::Publisher::Publisher;
@@ -112,12 +412,15 @@ class Publisher : public ros::Publisher {
 public:
   Publisher &operator=(const ros::Publisher &x) {
     ros::Publisher::operator=(x);
+    if(queue_) {
+      async(queue_->policy());
+    }
     return *this;
   }
   
   /**
    * @brief Publishes an OpenCV Mat as a ROS Image message.
-   * @param img The input OpenCV Mat to be published.
+   * @param img The input OpenCV Mat to be published. In asynchronous mode it is shared, not copied, so it must not be modified afterwards (publish a clone if the buffer is reused).
    * @param time The ROS time to be associated with the message.
    * @param frame_id The frame ID for the ROS message.
    */
@@ -125,8 +428,327 @@ public:
     std_msgs::Header header;
     header.stamp = time;
     header.frame_id = frame_id;
-    ros::Publisher::publish(cv2ros(img, header));
+    if(queue_) {
+      queue_->push(img, std::move(header));
+      return;
+    }
+    const sensor_msgs::ImagePtr msg = pool_->acquire();
+    cv2ros(img, *msg, header);
+    ros::Publisher::publish(sensor_msgs::ImageConstPtr(msg));
   }
+
+  /**
+   * @brief Publishes a ROS Image message.
+   * @param msg The message to be published.
+   */
+  void publish(const sensor_msgs::ImageConstPtr &msg) const {
+    ros::Publisher::publish(msg);
+  }
+
+  /**
+   * @brief Publishes a ROS Image message.
+   * @param msg The message to be published.
+   */
+  void publish(const sensor_msgs::Image &msg) const {
+    ros::Publisher::publish(msg);
+  }
+
+  /**
+   * @brief Allocates a ROS Image message whose data can be written through an OpenCV Mat.
+   * @param size The size of the image.
+   * @param type The OpenCV type of the image (e.g., CV_8UC3).
+   * @param header The header for the ROS Image message.
+   * @return The loaned image, to be filled and passed to publish.
+   * @see rush::roscv::loan
+   */
+  [[nodiscard]] LoanedImage loan(const cv::Size &size, const int type, const std_msgs::Header &header = std_msgs::Header()) const {
+    return detail::lend(pool_->acquire(), size, type, header);
+  }
+
+  /**
+   * @brief Publishes a loaned image without copying its pixels, keeping the header it was loaned with.
+   * @param img The loaned image. It is released after publishing, since subscribers may still be reading it.
+   */
+  void publish(LoanedImage &&img) {
+    LoanedImage loaned = std::move(img);
+    loaned.mat.release();
+    ros::Publisher::publish(sensor_msgs::ImageConstPtr(std::move(loaned.msg)));
+  }
+
+  /**
+   * @brief Publishes a loaned image without copying its pixels, replacing its stamp and frame ID.
+   * @param img The loaned image. It is released after publishing, since subscribers may still be reading it.
+   * @param time The ROS time to be associated with the message.
+   * @param frame_id The frame ID for the ROS message.
+   */
+  void publish(LoanedImage &&img, const ros::Time &time, const std::string &frame_id) {
+    img.msg->header.stamp = time;
+    img.msg->header.frame_id = frame_id;
+    publish(std::move(img));
+  }
+
+  /**
+   * @brief Gets the pool of messages used by this publisher.
+   * @return The pool, to configure its capacity or read its statistics.
+   */
+  [[nodiscard]] ImagePool &pool() const {
+    return *pool_;
+  }
+
+  /**
+   * @brief Publishes OpenCV matrices from a dedicated thread.
+   * @param policy What to do with pending frames when new ones arrive faster than they are published.
+   */
+  void async(const PublishPolicy policy = PublishPolicy::drop_oldest) {
+    queue_.reset();
+    queue_ = std::make_shared<detail::PublishQueue>(*this, pool_, policy);
+  }
+
+  /**
+   * @brief Publishes OpenCV matrices from the calling thread again, after flushing pending frames.
+   */
+  void sync() {
+    queue_.reset();
+  }
+
+  /**
+   * @brief Gets the number of frames waiting to be published in asynchronous mode.
+   * @return The queue depth.
+   */
+  [[nodiscard]] std::size_t queued() const {
+    return queue_ ? queue_->depth() : 0;
+  }
+
+  /**
+   * @brief Gets the number of frames discarded in asynchronous mode.
+   * @return The number of dropped frames.
+   */
+  [[nodiscard]] std::size_t dropped() const {
+    return queue_ ? queue_->dropped() : 0;
+  }
+
+private:
+  std::shared_ptr<ImagePool> pool_{std::make_shared<ImagePool>()};
+  std::shared_ptr<detail::PublishQueue> queue_;
+};
+
+/**
+ * @brief Configuration structure for compressed publishers.
+ */
+struct CompressedConfiguration {
+  std::string format{"jpeg"}; ///< Compression format, either "jpeg" or "png".
+  int quality{-1};            ///< JPEG quality (0-100) or PNG compression level (0-9). If negative, 90 for JPEG and 3 for PNG. With a target bandwidth, this is the maximum JPEG quality.
+  double bandwidth{0.0};      ///< Target bandwidth in bytes per second. If zero, the quality is fixed.
+  std::size_t in_flight{4};   ///< Maximum number of frames being encoded at the same time. Further frames are dropped.
+};
+
+/*! \cond INTERNAL */
+namespace detail {
+
+class CompressedState {
+public:
+  static constexpr int min_quality = 10;
+  static constexpr int quality_step = 5;
+
+  CompressedState(const ros::Publisher &publisher, CompressedConfiguration cfg) : publisher_{publisher}, config_{validate(std::move(cfg))}, pool_{std::max<std::size_t>(1, config_.in_flight)}, quality_{config_.quality} {}
+
+  bool acquire() {
+    std::size_t n = in_flight_.load(std::memory_order_relaxed);
+    do {
+      if(n >= config_.in_flight) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    } while(!in_flight_.compare_exchange_weak(n, n + 1, std::memory_order_relaxed));
+    return true;
+  }
+
+  void encode(const cv::Mat &img, const std_msgs::Header &header, const std::uint64_t seq) {
+    bool published = false;
+    try {
+      const sensor_msgs::CompressedImagePtr msg = pool_.acquire();
+      msg->header = header;
+      const std::string encoding = Encoding::get(img);
+      msg->format = encoding.empty() ? config_.format : encoding + "; " + config_.format + " compressed " + encoding;
+      const int quality = quality_.load(std::memory_order_relaxed);
+      const std::vector<int> params = (config_.format == "jpeg") ? std::vector<int>{cv::IMWRITE_JPEG_QUALITY, quality} : std::vector<int>{cv::IMWRITE_PNG_COMPRESSION, quality};
+      if(cv::imencode("." + config_.format, img, msg->data, params)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(seq > last_) {
+          last_ = seq;
+          adapt(msg->data.size());
+          publisher_.publish(sensor_msgs::CompressedImageConstPtr(msg));
+          published = true;
+        }
+      }
+    } catch(const std::exception &) {
+      published = false;
+    }
+    if(!published) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] int quality() const {
+    return quality_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::size_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] double bandwidth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (interval_ > 0) ? bytes_ / interval_ : 0.0;
+  }
+
+  std::atomic<std::uint64_t> seq{0};
+
+private:
+  static CompressedConfiguration validate(CompressedConfiguration cfg) {
+    int max_quality;
+    if(cfg.format == "jpeg") {
+      max_quality = 100;
+      cfg.quality = (cfg.quality < 0) ? 90 : cfg.quality;
+    } else if(cfg.format == "png") {
+      max_quality = 9;
+      cfg.quality = (cfg.quality < 0) ? 3 : cfg.quality;
+    } else {
+      throw std::invalid_argument("Unsupported compression format " + cfg.format);
+    }
+    if(cfg.quality > max_quality) {
+      throw std::invalid_argument("Compression quality " + std::to_string(cfg.quality) + " out of range for " + cfg.format);
+    }
+    return cfg;
+  }
+
+  void adapt(const std::size_t size) {
+    static constexpr double alpha = 0.1;
+    const auto now = std::chrono::steady_clock::now();
+    if(stamp_ != std::chrono::steady_clock::time_point()) {
+      const double dt = std::chrono::duration<double>(now - stamp_).count();
+      interval_ = (interval_ > 0) ? (1 - alpha) * interval_ + alpha * dt : dt;
+    }
+    stamp_ = now;
+    bytes_ = (bytes_ > 0) ? (1 - alpha) * bytes_ + alpha * static_cast<double>(size) : static_cast<double>(size);
+    if(config_.bandwidth <= 0 || config_.format != "jpeg" || interval_ <= 0) {
+      return;
+    }
+    const double rate = bytes_ / interval_;
+    int quality = quality_.load(std::memory_order_relaxed);
+    if(rate > 1.05 * config_.bandwidth) {
+      quality = std::max(min_quality, quality - quality_step);
+    } else if(rate < 0.8 * config_.bandwidth) {
+      quality = std::min(config_.quality, quality + quality_step);
+    }
+    quality_.store(quality, std::memory_order_relaxed);
+  }
+
+  ros::Publisher publisher_;
+  CompressedConfiguration config_;
+  MessagePool<sensor_msgs::CompressedImage> pool_;
+  std::atomic<int> quality_;
+  std::atomic<std::size_t> in_flight_{0};
+  std::atomic<std::size_t> dropped_{0};
+  mutable std::mutex mutex_;
+  std::uint64_t last_{0};
+  std::chrono::steady_clock::time_point stamp_{};
+  double interval_{0.0};
+  double bytes_{0.0};
+};
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief This class extends ros::Publisher to publish OpenCV matrices as compressed images.
+ *
+ * Frames are encoded with cv::imencode on the library thread pool, so several frames can be in flight while
+ * the caller keeps processing. Encoded messages and their buffers are reused across frames, frames that
+ * finish after a newer one are dropped to keep the stream ordered, and the JPEG quality can be adapted
+ * to hold a target bandwidth.
+ *
+ * @example
+ * @code
+ * ros::NodeHandle nh;
+ * rush::roscv::CompressedPublisher pub(nh.advertise<sensor_msgs::CompressedImage>("image/compressed", 1), {"jpeg", 90, 2e6});
+ * pub.publish(frame);
+ * @endcode
+ */
+class CompressedPublisher : public ros::Publisher {
+public:
+  CompressedPublisher() = default;
+
+  /**
+   * @brief Constructor.
+   * @param publisher A publisher advertising sensor_msgs::CompressedImage.
+   * @param cfg Configuration of the compression.
+   * @throws std::invalid_argument If the compression format is not supported or the quality is out of its range.
+   */
+  explicit CompressedPublisher(const ros::Publisher &publisher, CompressedConfiguration cfg = CompressedConfiguration()) : ros::Publisher(publisher), state_{std::make_shared<detail::CompressedState>(publisher, std::move(cfg))} {}
+
+  /**
+   * @brief Publishes a ROS CompressedImage message.
+   * @param msg The message to be published.
+   */
+  void publish(const sensor_msgs::CompressedImageConstPtr &msg) const {
+    ros::Publisher::publish(msg);
+  }
+
+  /**
+   * @brief Publishes a ROS CompressedImage message.
+   * @param msg The message to be published.
+   */
+  void publish(const sensor_msgs::CompressedImage &msg) const {
+    ros::Publisher::publish(msg);
+  }
+
+  /**
+   * @brief Compresses and publishes an OpenCV Mat asynchronously.
+   * @param img The input OpenCV Mat to be published. It is shared, not copied, so it must not be modified afterwards (publish a clone if the buffer is reused).
+   * @param time The ROS time to be associated with the message.
+   * @param frame_id The frame ID for the ROS message.
+   * @return True if the frame was queued for encoding, false if it was dropped because too many frames are in flight.
+   */
+  bool publish(const cv::Mat &img, const ros::Time &time = ros::Time::now(), const std::string &frame_id = "") {
+    if(!state_ || !state_->acquire()) {
+      return false;
+    }
+    std_msgs::Header header;
+    header.stamp = time;
+    header.frame_id = frame_id;
+    const std::uint64_t seq = state_->seq.fetch_add(1, std::memory_order_relaxed) + 1;
+    ThreadPool::global().execute([state = state_, img, header = std::move(header), seq] { state->encode(img, header, seq); });
+    return true;
+  }
+
+  /**
+   * @brief Gets the current compression quality.
+   * @return The JPEG quality or PNG compression level.
+   */
+  [[nodiscard]] int quality() const {
+    return state_ ? state_->quality() : 0;
+  }
+
+  /**
+   * @brief Gets the measured output bandwidth.
+   * @return The average size of the published messages times their rate, in bytes per second.
+   */
+  [[nodiscard]] double bandwidth() const {
+    return state_ ? state_->bandwidth() : 0.0;
+  }
+
+  /**
+   * @brief Gets the number of frames discarded because too many were in flight, encoding failed or a newer one was published first.
+   * @return The number of dropped frames.
+   */
+  [[nodiscard]] std::size_t dropped() const {
+    return state_ ? state_->dropped() : 0;
+  }
+
+private:
+  std::shared_ptr<detail::CompressedState> state_;
 };
 
 } // namespace rush::roscv
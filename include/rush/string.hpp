@@ -41,7 +41,7 @@ public:
    * @endcode
    */
   string operator*(int times) const {
-    rush::clampl(times, 0);
+    rush::clampl_inplace(times, 0);
     string r;
     r.reserve(string::size() * times);
     while(times-- > 0) {
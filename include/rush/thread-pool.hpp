@@ -0,0 +1,370 @@
+/**
+ * @file thread-pool.hpp
+ * @brief This library provides a work-stealing thread pool.
+ * @author Raul Tapia (raultapia.com)
+ * @copyright GNU General Public License v3.0
+ * @see https://github.com/raultapia/rush
+ */
+#ifndef RUSH_THREAD_POOL_HPP
+#define RUSH_THREAD_POOL_HPP
+
+#include "rush/counter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#endif
+
+namespace rush {
+
+/*! \cond INTERNAL */
+namespace detail {
+
+class WorkStealingDeque {
+public:
+  using Task = std::function<void()>;
+
+  WorkStealingDeque() {
+    arrays_.push_back(std::make_unique<Array>(256));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  void push(Task *task) {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t t = top_.load(std::memory_order_acquire);
+    Array *a = array_.load(std::memory_order_relaxed);
+    if(b - t > a->capacity - 1) {
+      arrays_.push_back(std::make_unique<Array>(2 * a->capacity));
+      for(std::int64_t i = t; i < b; i++) {
+        arrays_.back()->put(i, a->get(i));
+      }
+      a = arrays_.back().get();
+      array_.store(a, std::memory_order_release);
+    }
+    a->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  Task *pop() {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array *a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+    Task *task = nullptr;
+    if(t <= b) {
+      task = a->get(b);
+      if(t == b) {
+        if(!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          task = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  Task *steal() {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom_.load(std::memory_order_acquire);
+    if(t >= b) {
+      return nullptr;
+    }
+    Task *task = array_.load(std::memory_order_acquire)->get(t);
+    return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed) ? task : nullptr;
+  }
+
+private:
+  struct Array {
+    explicit Array(const std::int64_t n) : capacity{n}, slots{new std::atomic<Task *>[static_cast<std::size_t>(n)]} {}
+
+    [[nodiscard]] Task *get(const std::int64_t i) const {
+      return slots[static_cast<std::size_t>(i & (capacity - 1))].load(std::memory_order_relaxed);
+    }
+
+    void put(const std::int64_t i, Task *task) {
+      slots[static_cast<std::size_t>(i & (capacity - 1))].store(task, std::memory_order_relaxed);
+    }
+
+    const std::int64_t capacity;
+    std::unique_ptr<std::atomic<Task *>[]> slots;
+  };
+
+  alignas(cache_line_size) std::atomic<std::int64_t> top_{0};
+  alignas(cache_line_size) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Array *> array_{nullptr};
+  std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+} // namespace detail
+/*! \endcond */
+
+/**
+ * @brief A thread pool in which idle workers steal tasks from the queues of busy workers.
+ *
+ * Each worker owns a lock-free Chase-Lev deque. Tasks submitted from a worker are pushed to its own deque
+ * and popped in LIFO order, while idle workers steal the oldest tasks from other deques.
+ * Tasks submitted from other threads go through a shared injection queue.
+ * Idle workers sleep on a futex (Linux) instead of spinning.
+ *
+ * @example
+ * @code
+ * rush::ThreadPool pool(4);
+ * std::future<int> f = pool.submit([](int x) { return x * x; }, 7);
+ * int y = f.get(); // y is 49
+ * @endcode
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param threads The number of worker threads.
+   * @param pin Whether to pin worker i to CPU i (modulo the number of CPUs). Only supported on Linux.
+   */
+  explicit ThreadPool(const std::size_t threads = std::max(1U, std::thread::hardware_concurrency()), [[maybe_unused]] const bool pin = false) : deques_(std::max<std::size_t>(1, threads)) {
+    workers_.reserve(deques_.size());
+    for(std::size_t i = 0; i < deques_.size(); i++) {
+      workers_.emplace_back([this, i]() { run(i); });
+#if defined(__linux__)
+      if(pin) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(i % std::max(1U, std::thread::hardware_concurrency()), &set);
+        pthread_setaffinity_np(workers_.back().native_handle(), sizeof(set), &set);
+      }
+#endif
+    }
+  }
+
+  /**
+   * @brief Destructor. Pending tasks are completed before the workers are joined.
+   */
+  ~ThreadPool() {
+    stop_.store(true);
+    wake(INT_MAX);
+    for(std::thread &w : workers_) {
+      w.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) noexcept = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool &operator=(ThreadPool &&other) noexcept = delete;
+
+  /**
+   * @brief Execute a task asynchronously.
+   *
+   * @param task The task to execute. It must not throw.
+   */
+  void execute(std::function<void()> task) {
+    auto *t = new std::function<void()>(std::move(task));
+    const std::pair<ThreadPool *, std::size_t> &self = current();
+    if(self.first == this) {
+      deques_[self.second].push(t);
+    } else {
+      std::lock_guard<std::mutex> lock(inject_mutex_);
+      inject_.push_back(t);
+      injected_.fetch_add(1, std::memory_order_release);
+    }
+    wake(1);
+  }
+
+  /**
+   * @brief Submit a function for asynchronous execution.
+   *
+   * @param f The function to execute.
+   * @param args The arguments passed to the function.
+   * @return A future holding the result of the function, or the exception it threw.
+   */
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> submit(F &&f, Args &&...args) {
+    using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+    auto task = std::make_shared<std::packaged_task<R()>>([f = std::forward<F>(f), tuple = std::make_tuple(std::forward<Args>(args)...)]() mutable { return std::apply(std::move(f), std::move(tuple)); });
+    std::future<R> future = task->get_future();
+    execute([task]() { (*task)(); });
+    return future;
+  }
+
+  /**
+   * @brief Run a function over an index range split into chunks, and wait for completion.
+   *
+   * Chunks are handed out dynamically to the workers and to the calling thread, which also takes part.
+   *
+   * @param begin The first index.
+   * @param end The index past the last one.
+   * @param chunk The number of indices per chunk. If zero, it is chosen to give about four chunks per worker.
+   * @param f Callable invoked as `f(chunk_begin, chunk_end)`. It must not throw.
+   */
+  template <typename F>
+  void parallel_for(const std::size_t begin, const std::size_t end, std::size_t chunk, F &&f) {
+    if(begin >= end) {
+      return;
+    }
+    chunk = (chunk > 0) ? chunk : chunk_size(end - begin);
+    const std::size_t chunks = (end - begin + chunk - 1) / chunk;
+    if(chunks == 1) {
+      f(begin, end);
+      return;
+    }
+
+    struct State {
+      std::atomic<std::size_t> next{0};
+      std::atomic<std::size_t> done{0};
+    };
+    const std::shared_ptr<State> state = std::make_shared<State>();
+    const std::function<void()> body = [state, &f, begin, end, chunk, chunks]() {
+      for(std::size_t c = state->next.fetch_add(1, std::memory_order_relaxed); c < chunks; c = state->next.fetch_add(1, std::memory_order_relaxed)) {
+        const std::size_t b = begin + c * chunk;
+        f(b, std::min(end, b + chunk));
+        state->done.fetch_add(1, std::memory_order_release);
+      }
+    };
+
+    for(std::size_t i = std::min(deques_.size(), chunks - 1); i > 0; i--) {
+      execute(body);
+    }
+    body();
+    while(state->done.load(std::memory_order_acquire) < chunks) {
+      std::this_thread::yield();
+    }
+  }
+
+  /**
+   * @brief Get the default chunk size for a range.
+   *
+   * @param n The number of indices.
+   * @return The number of indices per chunk.
+   */
+  [[nodiscard]] std::size_t chunk_size(const std::size_t n) const {
+    return std::max<std::size_t>(1, n / (4 * deques_.size()));
+  }
+
+  /**
+   * @brief Get the number of worker threads.
+   *
+   * @return The number of worker threads.
+   */
+  [[nodiscard]] std::size_t size() const {
+    return deques_.size();
+  }
+
+  /**
+   * @brief Get the pool shared by the library, with one worker per hardware thread.
+   *
+   * @return The shared pool.
+   */
+  static ThreadPool &global() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+private:
+  using Task = detail::WorkStealingDeque::Task;
+
+  static std::pair<ThreadPool *, std::size_t> &current() {
+    thread_local std::pair<ThreadPool *, std::size_t> self{nullptr, 0};
+    return self;
+  }
+
+  Task *find(const std::size_t i) {
+    if(Task *t = deques_[i].pop()) {
+      return t;
+    }
+    if(injected_.load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> lock(inject_mutex_);
+      if(!inject_.empty()) {
+        Task *t = inject_.front();
+        inject_.pop_front();
+        injected_.fetch_sub(1, std::memory_order_relaxed);
+        return t;
+      }
+    }
+    for(std::size_t k = 1; k < deques_.size(); k++) {
+      if(Task *t = deques_[(i + k) % deques_.size()].steal()) {
+        return t;
+      }
+    }
+    return nullptr;
+  }
+
+  void wake(const int n) {
+    epoch_.fetch_add(1);
+    if(sleeping_.load() > 0) {
+#if defined(__linux__)
+      syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+#endif
+    }
+  }
+
+  void park(const std::uint32_t epoch) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);
+#else
+    if(epoch_.load() == epoch) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+#endif
+  }
+
+  void run(const std::size_t i) {
+    current() = {this, i};
+    for(;;) {
+      Task *t = find(i);
+      if(t == nullptr) {
+        const std::uint32_t epoch = epoch_.load();
+        sleeping_.fetch_add(1);
+        t = find(i);
+        if(t == nullptr) {
+          if(stop_.load()) {
+            sleeping_.fetch_sub(1);
+            return;
+          }
+          park(epoch);
+        }
+        sleeping_.fetch_sub(1);
+      }
+      if(t != nullptr) {
+        const std::unique_ptr<Task> task(t);
+        (*task)();
+      }
+    }
+  }
+
+  std::vector<detail::WorkStealingDeque> deques_;
+  std::vector<std::thread> workers_;
+  std::mutex inject_mutex_;
+  std::deque<Task *> inject_;
+  std::atomic<std::size_t> injected_{0};
+  alignas(cache_line_size) std::atomic<std::uint32_t> epoch_{0};
+  std::atomic<int> sleeping_{0};
+  std::atomic<bool> stop_{false};
+};
+
+} // namespace rush
+
+#endif // RUSH_THREAD_POOL_HPP